@@ -0,0 +1,447 @@
+#pragma once
+
+#include <cctype>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "point.h"
+#include "segment.h"
+
+/*
+ * Binary geometry files.
+ *
+ * A file is a sequence of sections. Each one is a 64-byte section_header and then count elements
+ * of packed native scalars, starting at the next multiple of the section alignment (counted from
+ * the start of the file); the section is padded to its alignment too. Sections are mapped
+ * read-only and handed out as views, without parsing or copying.
+ *
+ *   POINT   -- x y
+ *   SEGMENT -- x1 y1 x2 y2
+ *   LINE    -- a b c (the line a x + b y + c = 0)
+ *   INDEX   -- i, unsigned (offsets into or indices of other sections)
+ */
+
+namespace cg {
+
+enum class element_type : std::uint32_t {
+    POINT = 1,
+    SEGMENT = 2,
+    LINE = 3,
+    INDEX = 4
+};
+
+enum class scalar_type : std::uint32_t {
+    INT64 = 1,
+    FLOAT64 = 2,
+    UINT64 = 3
+};
+
+template<typename T>
+struct line_t {
+    T a;
+    T b;
+    T c;
+};
+
+struct section_header {
+    char magic[8];
+    std::uint32_t byte_order;
+    element_type element;
+    scalar_type scalar;
+    std::uint32_t alignment;
+    std::uint64_t count;
+    std::uint8_t reserved[32];
+};
+
+static_assert(sizeof(section_header) == 64, "section headers are 64 bytes");
+
+namespace detail {
+
+constexpr char binary_magic[8] = {'C', 'G', 'B', 'I', 'N', 0, 0, 1};
+constexpr std::uint32_t binary_byte_order = 0x01020304;
+
+template<typename T>
+struct scalar_of;
+
+template<>
+struct scalar_of<long long> {
+    static constexpr scalar_type value = scalar_type::INT64;
+};
+
+template<>
+struct scalar_of<double> {
+    static constexpr scalar_type value = scalar_type::FLOAT64;
+};
+
+template<typename T>
+struct element_of;
+
+template<typename T>
+struct element_of<point_t<T>> {
+    static constexpr element_type element = element_type::POINT;
+    static constexpr scalar_type scalar = scalar_of<T>::value;
+};
+
+template<typename T>
+struct element_of<segment_t<T>> {
+    static constexpr element_type element = element_type::SEGMENT;
+    static constexpr scalar_type scalar = scalar_of<T>::value;
+};
+
+template<typename T>
+struct element_of<line_t<T>> {
+    static constexpr element_type element = element_type::LINE;
+    static constexpr scalar_type scalar = scalar_of<T>::value;
+};
+
+template<>
+struct element_of<std::uint64_t> {
+    static constexpr element_type element = element_type::INDEX;
+    static constexpr scalar_type scalar = scalar_type::UINT64;
+};
+
+inline std::uint64_t align_up(std::uint64_t offset, std::uint64_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+}
+
+/*
+ * Read-only view of elements stored contiguously elsewhere.
+ */
+template<typename T>
+class array_view {
+public:
+    array_view() : data_(nullptr), size_(0) {}
+
+    array_view(T const *data, std::size_t size) : data_(data), size_(size) {}
+
+    [[nodiscard]] T const *begin() const {
+        return data_;
+    }
+
+    [[nodiscard]] T const *end() const {
+        return data_ + size_;
+    }
+
+    [[nodiscard]] T const &operator[](std::size_t i) const {
+        return data_[i];
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return size_;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return size_ == 0;
+    }
+
+private:
+    T const *data_;
+    std::size_t size_;
+};
+
+/*
+ * Memory-mapped binary geometry file. Throws std::runtime_error on I/O errors and malformed files.
+ */
+class mapped_file {
+public:
+    mapped_file() : data_(nullptr), size_(0) {}
+
+    explicit mapped_file(std::string const &path) : data_(nullptr), size_(0) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open " + path);
+        }
+        struct stat info{};
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("cannot stat " + path);
+        }
+        size_ = info.st_size;
+        if (size_ > 0) {
+            void *data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("cannot map " + path);
+            }
+            data_ = static_cast<char const *>(data);
+        }
+        ::close(fd);
+        parse(path);
+    }
+
+    mapped_file(mapped_file const &) = delete;
+
+    mapped_file &operator=(mapped_file const &) = delete;
+
+    mapped_file(mapped_file &&other) noexcept : data_(nullptr), size_(0) {
+        *this = std::move(other);
+    }
+
+    mapped_file &operator=(mapped_file &&other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(sections_, other.sections_);
+        return *this;
+    }
+
+    ~mapped_file() {
+        if (data_ != nullptr) {
+            ::munmap(const_cast<char *>(data_), size_);
+        }
+    }
+
+    explicit operator bool() const {
+        return data_ != nullptr;
+    }
+
+    [[nodiscard]] std::size_t sections() const {
+        return sections_.size();
+    }
+
+    [[nodiscard]] section_header const &header(std::size_t i) const {
+        return *reinterpret_cast<section_header const *>(data_ + sections_.at(i).first);
+    }
+
+    /*
+     * Elements of section i, which must hold exactly T (e.g. point_t<long long>).
+     */
+    template<typename T>
+    [[nodiscard]] array_view<T> view(std::size_t i) const {
+        section_header const &h = header(i);
+        if (h.element != detail::element_of<T>::element || h.scalar != detail::element_of<T>::scalar) {
+            throw std::runtime_error("section " + std::to_string(i) + " holds another element type");
+        }
+        return {reinterpret_cast<T const *>(data_ + sections_[i].second), std::size_t(h.count)};
+    }
+
+private:
+    char const *data_;
+    std::size_t size_;
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> sections_;     // header and data offsets
+
+    static std::uint64_t element_size(section_header const &h) {
+        std::uint64_t scalars = h.element == element_type::POINT ? 2
+                                : h.element == element_type::SEGMENT ? 4
+                                : h.element == element_type::LINE ? 3
+                                : h.element == element_type::INDEX ? 1 : 0;
+        bool known = h.scalar == scalar_type::INT64 || h.scalar == scalar_type::FLOAT64 ||
+                     h.scalar == scalar_type::UINT64;
+        return known ? scalars * 8 : 0;
+    }
+
+    void parse(std::string const &path) {
+        std::uint64_t offset = 0;
+        while (offset < size_) {
+            if (size_ - offset < sizeof(section_header)) {
+                throw std::runtime_error(path + ": truncated section header");
+            }
+            section_header const &h = *reinterpret_cast<section_header const *>(data_ + offset);
+            if (std::memcmp(h.magic, detail::binary_magic, sizeof(h.magic)) != 0) {
+                throw std::runtime_error(path + ": not a binary geometry file");
+            }
+            if (h.byte_order != detail::binary_byte_order) {
+                throw std::runtime_error(path + ": written with another byte order");
+            }
+            std::uint64_t size = element_size(h);
+            if (size == 0 || h.alignment < 8 || h.alignment > 4096 || (h.alignment & (h.alignment - 1)) != 0) {
+                throw std::runtime_error(path + ": unsupported section format");
+            }
+            std::uint64_t data = detail::align_up(offset + sizeof(section_header), h.alignment);
+            if (data > size_ || h.count > (size_ - data) / size) {
+                throw std::runtime_error(path + ": truncated section data");
+            }
+            sections_.emplace_back(offset, data);
+            offset = detail::align_up(data + h.count * size, h.alignment);
+        }
+    }
+};
+
+/*
+ * Writes sections of a binary geometry file to a stream, which may be a pipe.
+ */
+class binary_writer {
+public:
+    explicit binary_writer(std::ostream &out) : out_(out), offset_(0) {}
+
+    template<typename T>
+    void write(T const *data, std::size_t count, std::uint32_t alignment = 64) {
+        static_assert(sizeof(T) % 8 == 0, "elements are packed 8-byte scalars");
+        section_header h{};
+        std::memcpy(h.magic, detail::binary_magic, sizeof(h.magic));
+        h.byte_order = detail::binary_byte_order;
+        h.element = detail::element_of<T>::element;
+        h.scalar = detail::element_of<T>::scalar;
+        h.alignment = alignment;
+        h.count = count;
+        put(&h, sizeof(h));
+        pad(alignment);
+        put(data, count * sizeof(T));
+        pad(alignment);
+    }
+
+    template<typename T>
+    void write(std::vector<T> const &data, std::uint32_t alignment = 64) {
+        write(data.data(), data.size(), alignment);
+    }
+
+private:
+    std::ostream &out_;
+    std::uint64_t offset_;
+
+    void put(void const *data, std::size_t size) {
+        out_.write(static_cast<char const *>(data), size);
+        offset_ += size;
+    }
+
+    void pad(std::uint32_t alignment) {
+        static char const zeros[4096] = {};
+        put(zeros, detail::align_up(offset_, alignment) - offset_);
+    }
+};
+
+/*
+ * A mode of a cg_* tool: its flag and the kinds of its required and optional arguments, one
+ * letter each: 'u' unsigned integer, 'i' integer, 'r' real.
+ */
+struct tool_mode {
+    char const *flag;
+    char const *required = "";
+    char const *optional = "";
+};
+
+namespace detail {
+
+inline bool valid_argument(std::string const &s, char kind) {
+    char const *begin = s.c_str();
+    char *end = nullptr;
+    errno = 0;
+    if (kind == 'u') {
+        if (!std::isdigit((unsigned char) *begin)) {
+            return false;
+        }
+        std::strtoull(begin, &end, 10);
+    } else if (kind == 'i') {
+        std::strtoll(begin, &end, 10);
+    } else {
+        std::strtold(begin, &end);
+    }
+    return !s.empty() && end == begin + s.size() && errno == 0;
+}
+
+}
+
+/*
+ * Command line of a cg_* tool: "--binary <path>" anywhere, and at most one of the modes followed
+ * by its arguments. Anything else leaves a usage message in error() instead of throwing, so the
+ * tool can print it and exit.
+ */
+class tool_options {
+public:
+    tool_options(int argc, char **argv, std::initializer_list<tool_mode> modes) {
+        std::vector<std::string> rest;
+        for (int i = 1; i < argc; i++) {
+            if (std::string(argv[i]) != "--binary") {
+                rest.emplace_back(argv[i]);
+            } else if (i + 1 < argc && binary_.empty()) {
+                binary_ = argv[++i];
+            } else {
+                rest.clear();
+                rest.emplace_back("--binary");
+                break;
+            }
+        }
+        bool valid = rest.empty();
+        for (tool_mode const &m : modes) {
+            std::size_t required = std::strlen(m.required), optional = std::strlen(m.optional);
+            if (!rest.empty() && rest[0] == m.flag && rest.size() - 1 >= required &&
+                rest.size() - 1 <= required + optional) {
+                valid = true;
+                for (std::size_t i = 1; i < rest.size(); i++) {
+                    valid &= detail::valid_argument(rest[i], i <= required ? m.required[i - 1]
+                                                                          : m.optional[i - 1 - required]);
+                }
+                if (valid) {
+                    mode_ = rest[0];
+                    arguments_.assign(rest.begin() + 1, rest.end());
+                }
+                break;
+            }
+        }
+        if (!valid) {
+            error_ = std::string("usage: ") + (argc > 0 ? argv[0] : "cg") + " [--binary <path>]";
+            for (tool_mode const &m : modes) {
+                error_ += std::string(" [") + m.flag;
+                for (char const *k = m.required; *k != 0; k++) {
+                    error_ += std::string(" <") + *k + ">";
+                }
+                for (char const *k = m.optional; *k != 0; k++) {
+                    error_ += std::string(" [") + *k + "]";
+                }
+                error_ += "]";
+            }
+            error_ += "\n  <u> unsigned integer, <i> integer, <r> real";
+        }
+    }
+
+    explicit operator bool() const {
+        return error_.empty();
+    }
+
+    [[nodiscard]] std::string const &error() const {
+        return error_;
+    }
+
+    /*
+     * Whether the mode given is flag; the default mode is "".
+     */
+    [[nodiscard]] bool is(char const *flag) const {
+        return mode_ == flag;
+    }
+
+    [[nodiscard]] std::size_t arguments() const {
+        return arguments_.size();
+    }
+
+    [[nodiscard]] unsigned long long unsigned_argument(std::size_t i, unsigned long long fallback) const {
+        return i < arguments_.size() ? std::stoull(arguments_[i]) : fallback;
+    }
+
+    [[nodiscard]] long long integer_argument(std::size_t i, long long fallback) const {
+        return i < arguments_.size() ? std::stoll(arguments_[i]) : fallback;
+    }
+
+    [[nodiscard]] long double real_argument(std::size_t i, long double fallback) const {
+        return i < arguments_.size() ? std::stold(arguments_[i]) : fallback;
+    }
+
+    /*
+     * The file given as "--binary <path>", or an empty mapping without that option.
+     */
+    [[nodiscard]] mapped_file binary() const {
+        return binary_.empty() ? mapped_file() : mapped_file(binary_);
+    }
+
+private:
+    std::string mode_;
+    std::vector<std::string> arguments_;
+    std::string binary_;
+    std::string error_;
+};
+
+}
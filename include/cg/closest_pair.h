@@ -0,0 +1,541 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "parallel.h"
+#include "point.h"
+#include "simd.h"
+
+namespace cg {
+
+struct closest_pair_result {
+    point_t<long long> p1;
+    point_t<long long> p2;
+    unsigned long long sqr_distance;
+};
+
+enum class closest_pair_method {
+    DIVIDE_AND_CONQUER,
+    GRID
+};
+
+namespace detail {
+
+std::size_t const closest_pair_leaf = 4;
+
+/*
+ * Best pair found by one task. With a shared bound, improvements are published to it and
+ * sync() narrows the search window to the best distance of all tasks.
+ */
+struct closest_pair_state {
+    closest_pair_result best;
+    long long reach;        // pairs with a coordinate difference of at least reach cannot improve
+    std::atomic<unsigned long long> *shared;
+
+    explicit closest_pair_state(std::atomic<unsigned long long> *shared = nullptr)
+            : best{point_t<long long>(), point_t<long long>(), std::numeric_limits<unsigned long long>::max()},
+              reach(std::numeric_limits<long long>::max()), shared(shared) {}
+
+    static long long reach_of(unsigned long long sqr_dist) {
+        return (long long) std::sqrt((long double) sqr_dist) + 1;
+    }
+
+    void relax(point_t<long long> const &p1, point_t<long long> const &p2) {
+        unsigned long long sqr_dist = (p2 - p1).to<unsigned long long>().sqr_length();
+        if (best.sqr_distance > sqr_dist) {
+            best = {p1, p2, sqr_dist};
+            reach = std::min(reach, reach_of(sqr_dist));
+            if (shared != nullptr) {
+                unsigned long long current = shared->load(std::memory_order_relaxed);
+                while (sqr_dist < current && !shared->compare_exchange_weak(current, sqr_dist,
+                                                                            std::memory_order_relaxed)) {}
+            }
+        }
+    }
+
+    void sync() {
+        if (shared != nullptr) {
+            unsigned long long current = shared->load(std::memory_order_relaxed);
+            if (current != std::numeric_limits<unsigned long long>::max()) {
+                reach = std::min(reach, reach_of(current));
+            }
+        }
+    }
+
+    void combine(closest_pair_state const &other) {
+        if (other.best.sqr_distance < best.sqr_distance) {
+            best = other.best;
+        }
+        reach = std::min(reach, other.reach);
+    }
+};
+
+/*
+ * Pair searches over the divide and conquer. A state has relax(p1, p2), called for candidate pairs,
+ * reach, the coordinate difference from which pairs are of no interest, and sync().
+ */
+template<typename F>
+struct near_pairs_state {
+    unsigned long long sqr_radius;
+    long long reach;
+    F &report;
+
+    near_pairs_state(unsigned long long sqr_radius, F &report)
+            : sqr_radius(sqr_radius), reach(closest_pair_state::reach_of(sqr_radius)), report(report) {}
+
+    void relax(point_t<long long> const &p1, point_t<long long> const &p2) {
+        unsigned long long sqr_dist = (p2 - p1).to<unsigned long long>().sqr_length();
+        if (sqr_dist <= sqr_radius) {
+            report(p1, p2, sqr_dist);
+        }
+    }
+
+    void sync() {}
+};
+
+/*
+ * The k closest pairs so far, as a max-heap on the distance.
+ */
+struct k_closest_state {
+    std::vector<closest_pair_result> &heap;
+    std::size_t k;
+    long long reach;
+
+    k_closest_state(std::vector<closest_pair_result> &heap, std::size_t k)
+            : heap(heap), k(k), reach(std::numeric_limits<long long>::max()) {
+        heap.clear();
+    }
+
+    static bool nearer(closest_pair_result const &r1, closest_pair_result const &r2) {
+        return r1.sqr_distance < r2.sqr_distance;
+    }
+
+    void relax(point_t<long long> const &p1, point_t<long long> const &p2) {
+        unsigned long long sqr_dist = (p2 - p1).to<unsigned long long>().sqr_length();
+        if (heap.size() < k) {
+            heap.push_back({p1, p2, sqr_dist});
+            std::push_heap(heap.begin(), heap.end(), nearer);
+        } else if (sqr_dist < heap.front().sqr_distance) {
+            std::pop_heap(heap.begin(), heap.end(), nearer);
+            heap.back() = {p1, p2, sqr_dist};
+            std::push_heap(heap.begin(), heap.end(), nearer);
+        } else {
+            return;
+        }
+        if (heap.size() == k) {
+            reach = closest_pair_state::reach_of(heap.front().sqr_distance);
+        }
+    }
+
+    void sync() {}
+};
+
+/*
+ * Merges the y-sorted halves [l, m) and [m, r) through out, relaxing with the pairs across
+ * the vertical line x = mid within the reach of the state.
+ */
+template<typename State>
+void closest_pair_merge(point_t<long long> *a, point_t<long long> *out,
+                        std::size_t l, std::size_t m, std::size_t r, long long mid, State &state) {
+    state.sync();
+    std::size_t il = l, ir = m, lo = m, hi = m, k = l;
+    while (il < m || ir < r) {
+        if (ir == r || (il < m && a[il].y <= a[ir].y)) {
+            point_t<long long> const &p = a[il++];
+            if (mid - p.x < state.reach) {
+                while (lo < r && p.y - a[lo].y >= state.reach) {
+                    lo++;
+                }
+                hi = std::max(hi, lo);
+                while (hi < r && a[hi].y - p.y < state.reach) {
+                    hi++;
+                }
+                for (std::size_t near = lo; near < hi; near++) {
+                    if (a[near].x - mid < state.reach) {
+                        state.relax(p, a[near]);
+                    }
+                }
+            }
+            out[k++] = p;
+        } else {
+            out[k++] = a[ir++];
+        }
+    }
+    std::copy(out + l, out + r, a + l);
+}
+
+/*
+ * Relaxes with every pair in [l, r), sorted by x, and sorts the range by y.
+ */
+template<typename State>
+void closest_pair_collect(point_t<long long> *a, point_t<long long> *out, std::size_t l, std::size_t r,
+                          State &state) {
+    if (r - l <= closest_pair_leaf) {
+        for (std::size_t i = l; i < r; i++) {
+            for (std::size_t j = i + 1; j < r; j++) {
+                state.relax(a[i], a[j]);
+            }
+        }
+        std::sort(a + l, a + r, [](point_t<long long> const &p1, point_t<long long> const &p2) {
+            return p1.y < p2.y;
+        });
+        return;
+    }
+    std::size_t m = (l + r) / 2;
+    long long mid = a[m].x;
+    closest_pair_collect(a, out, l, m, state);
+    closest_pair_collect(a, out, m, r, state);
+    closest_pair_merge(a, out, l, m, r, mid, state);
+}
+
+/*
+ * Grid cell of the randomized closest pair. Points of one cell are at least the current distance
+ * apart, and a cell spans at most that distance, so a cell never holds more than four points.
+ */
+struct grid_bucket {
+    long long x[4];
+    long long y[4];
+    unsigned long long cx;
+    unsigned long long cy;
+    unsigned int size;
+};
+
+struct grid_slot {
+    std::uint32_t stamp;
+    std::uint32_t bucket;
+};
+
+/*
+ * The checks against a cell report the lanes that are strictly closer to p than sqr_bound.
+ * Vector checks are exact while the coordinate differences stay below 2^31, which holds for
+ * the neighbouring cells whenever the cell side is at most 2^30.
+ */
+inline unsigned int grid_closer_scalar(grid_bucket const &b, point_t<long long> const &p,
+                                       unsigned long long sqr_bound) {
+    unsigned int closer = 0;
+    for (unsigned int k = 0; k < b.size; k++) {
+        point_t<long long> d(b.x[k] - p.x, b.y[k] - p.y);
+        closer |= (unsigned int) (d.to<unsigned long long>().sqr_length() < sqr_bound) << k;
+    }
+    return closer;
+}
+
+#if CG_X86_SIMD
+
+CG_TARGET_AVX2 inline unsigned int grid_closer_avx2(grid_bucket const &b, point_t<long long> const &p,
+                                                    unsigned long long sqr_bound) {
+    __m256i dx = _mm256_sub_epi64(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(b.x)), _mm256_set1_epi64x(p.x));
+    __m256i dy = _mm256_sub_epi64(_mm256_loadu_si256(reinterpret_cast<__m256i const *>(b.y)), _mm256_set1_epi64x(p.y));
+    __m256i sx = _mm256_cmpgt_epi64(_mm256_setzero_si256(), dx);
+    __m256i sy = _mm256_cmpgt_epi64(_mm256_setzero_si256(), dy);
+    dx = _mm256_sub_epi64(_mm256_xor_si256(dx, sx), sx);
+    dy = _mm256_sub_epi64(_mm256_xor_si256(dy, sy), sy);
+    __m256i sqr = _mm256_add_epi64(_mm256_mul_epu32(dx, dx), _mm256_mul_epu32(dy, dy));
+    long long bound = (long long) std::min<unsigned long long>(sqr_bound, std::numeric_limits<long long>::max());
+    __m256i closer = _mm256_cmpgt_epi64(_mm256_set1_epi64x(bound), sqr);
+    return _mm256_movemask_pd(_mm256_castsi256_pd(closer)) & ((1u << b.size) - 1);
+}
+
+#endif
+
+inline unsigned int grid_closer(grid_bucket const &b, point_t<long long> const &p, unsigned long long sqr_bound,
+                                simd_level level) {
+    switch (level) {
+#if CG_X86_SIMD
+        case simd_level::AVX512:
+        case simd_level::AVX2:
+            return grid_closer_avx2(b, p, sqr_bound);
+#endif
+        default:
+            return grid_closer_scalar(b, p, sqr_bound);
+    }
+}
+
+}
+
+/*
+ * Closest pair by divide and conquer, O(n log n), or by randomized grid hashing, expected O(n).
+ * The engine is the whole state of a query: points are copied into its buffers, which are kept
+ * between queries, so a reused engine does not allocate. Use one engine per thread.
+ */
+class closest_pair_engine {
+public:
+    typedef point_t<long long> point;
+
+    /*
+     * The grid query shuffles with a generator seeded from std::random_device, so no fixed input
+     * order defeats it; a given seed makes it reproducible.
+     */
+    closest_pair_engine() : random_(random_seed()) {}
+
+    explicit closest_pair_engine(std::uint64_t seed) : random_(seed) {}
+
+    /*
+     * Closest pair of [first, last). Fewer than two points give an infinite distance.
+     */
+    closest_pair_result query(point const *first, point const *last) {
+        load(first, last);
+        std::sort(points_.begin(), points_.end(), by_x);
+        detail::closest_pair_state state;
+        if (points_.size() > 1) {
+            detail::closest_pair_collect(points_.data(), buffer_.data(), 0, points_.size(), state);
+        }
+        return state.best;
+    }
+
+    closest_pair_result query(std::vector<point> const &points) {
+        return query(points.data(), points.data() + points.size());
+    }
+
+    /*
+     * The same query on a pool: the x-sort is parallel_sort, subtrees of the recursion below
+     * the chunk size run as tasks, and the merges above them run level by level, each level's
+     * merges concurrently. Tasks share the best squared distance through an atomic to narrow
+     * their strips and reduce their pairs per subtree. Smaller inputs run sequentially.
+     */
+    closest_pair_result query(point const *first, point const *last, thread_pool &pool,
+                              std::size_t sequential_cutoff = 1u << 15) {
+        std::size_t n = last - first;
+        if (n < sequential_cutoff || pool.size() == 1) {
+            return query(first, last);
+        }
+        load(first, last);
+        parallel_sort(pool, points_.begin(), points_.end(), by_x);
+
+        std::size_t chunks = 1;
+        while (chunks < 4 * pool.size() && n / (2 * chunks) >= 4096) {
+            chunks *= 2;
+        }
+        auto bound = [n, chunks](std::size_t i) {
+            return n * i / chunks;
+        };
+        std::vector<long long> mid(chunks);
+        for (std::size_t i = 0; i < chunks; i++) {
+            mid[i] = points_[bound(i)].x;
+        }
+
+        std::atomic<unsigned long long> shared(std::numeric_limits<unsigned long long>::max());
+        std::vector<detail::closest_pair_state> states(chunks, detail::closest_pair_state(&shared));
+        point *a = points_.data(), *out = buffer_.data();
+        parallel_for(pool, chunks, [&](std::size_t i) {
+            detail::closest_pair_collect(a, out, bound(i), bound(i + 1), states[i]);
+        });
+        for (std::size_t width = 1; width < chunks; width *= 2) {
+            parallel_for(pool, chunks / (2 * width), [&](std::size_t i) {
+                std::size_t from = 2 * width * i, to = from + width;
+                states[from].combine(states[to]);
+                detail::closest_pair_merge(a, out, bound(from), bound(to), bound(to + width), mid[to], states[from]);
+            });
+        }
+        return states[0].best;
+    }
+
+    closest_pair_result query(std::vector<point> const &points, thread_pool &pool) {
+        return query(points.data(), points.data() + points.size(), pool);
+    }
+
+    /*
+     * Randomized incremental grid (Golin, Raman, Schwarz and Smid), expected O(n) on any input.
+     * Points are inserted in random order into a hash grid with cells as wide as the current
+     * distance, each one checked against the 3 x 3 cells around it. A closer pair rebuilds the grid
+     * of the points so far, which the i-th point causes with probability at most 2 / i.
+     * Uses about 100 bytes per point, three times the divide and conquer buffers.
+     */
+    closest_pair_result query_grid(point const *first, point const *last, simd_level level) {
+        typedef unsigned long long ull;
+        std::size_t n = last - first;
+        points_.assign(first, last);
+        detail::closest_pair_state state;
+        if (n < 2) {
+            return state.best;
+        }
+        for (std::size_t i = n - 1; i > 0; i--) {
+            std::swap(points_[i], points_[random_() % (i + 1)]);
+        }
+        origin_ = points_[0];
+        for (point const &p : points_) {
+            origin_.x = std::min(origin_.x, p.x);
+            origin_.y = std::min(origin_.y, p.y);
+        }
+        std::size_t capacity = 4;
+        shift_ = 62;
+        while (capacity < 2 * n) {
+            capacity *= 2;
+            shift_--;
+        }
+        if (table_.size() != capacity) {
+            table_.assign(capacity, {0, 0});
+            stamp_ = 0;
+        }
+
+        state.relax(points_[0], points_[1]);
+        rebuild(2, state.best.sqr_distance);
+        for (std::size_t i = 2; i < n && state.best.sqr_distance > 0; i++) {
+            point const &p = points_[i];
+            ull cx = cell(p.x, origin_.x), cy = cell(p.y, origin_.y);
+            ull before = state.best.sqr_distance;
+            simd_level checks = side_ <= (1ull << 30) ? level : simd_level::SCALAR;
+            for (ull x = cx - 1; x != cx + 2; x++) {
+                for (ull y = cy - 1; y != cy + 2; y++) {
+                    detail::grid_slot const &s = table_[slot(x, y)];
+                    if (s.stamp != stamp_) {
+                        continue;
+                    }
+                    detail::grid_bucket const &b = buckets_[s.bucket];
+                    for (unsigned int closer = detail::grid_closer(b, p, state.best.sqr_distance, checks);
+                         closer != 0; closer &= closer - 1) {
+                        unsigned int k = __builtin_ctz(closer);
+                        state.relax(point(b.x[k], b.y[k]), p);
+                    }
+                }
+            }
+            if (state.best.sqr_distance < before) {
+                rebuild(i + 1, state.best.sqr_distance);
+            } else {
+                insert(p, cx, cy);
+            }
+        }
+        return state.best;
+    }
+
+    closest_pair_result query_grid(point const *first, point const *last) {
+        return query_grid(first, last, detect_simd());
+    }
+
+    closest_pair_result query(point const *first, point const *last, closest_pair_method method) {
+        return method == closest_pair_method::GRID ? query_grid(first, last) : query(first, last);
+    }
+
+    closest_pair_result query(std::vector<point> const &points, closest_pair_method method) {
+        return query(points.data(), points.data() + points.size(), method);
+    }
+
+    /*
+     * Calls report(p1, p2, sqr_distance) for every pair of [first, last) at squared distance at most
+     * sqr_radius, in no particular order. The divide and conquer keeps its strip at the radius: beyond
+     * O(n log n), each point of a strip left of the split is tried against the right half's points
+     * within the radius of it in y, at any x, so a wide row of close points costs more than its output.
+     */
+    template<typename F>
+    void pairs_within(point const *first, point const *last, unsigned long long sqr_radius, F &&report) {
+        load(first, last);
+        std::sort(points_.begin(), points_.end(), by_x);
+        detail::near_pairs_state<F> state(sqr_radius, report);
+        if (points_.size() > 1) {
+            detail::closest_pair_collect(points_.data(), buffer_.data(), 0, points_.size(), state);
+        }
+    }
+
+    template<typename F>
+    void pairs_within(std::vector<point> const &points, unsigned long long sqr_radius, F &&report) {
+        pairs_within(points.data(), points.data() + points.size(), sqr_radius, std::forward<F>(report));
+    }
+
+    /*
+     * Calls report(p1, p2, sqr_distance) for the k closest pairs of [first, last), or all of them
+     * if there are fewer, in increasing order of distance. The strip narrows to the k-th best pair.
+     */
+    template<typename F>
+    void k_closest_pairs(point const *first, point const *last, std::size_t k, F &&report) {
+        load(first, last);
+        std::sort(points_.begin(), points_.end(), by_x);
+        detail::k_closest_state state(heap_, k);
+        if (points_.size() > 1 && k > 0) {
+            detail::closest_pair_collect(points_.data(), buffer_.data(), 0, points_.size(), state);
+        }
+        std::sort_heap(heap_.begin(), heap_.end(), detail::k_closest_state::nearer);
+        for (closest_pair_result const &pair : heap_) {
+            report(pair.p1, pair.p2, pair.sqr_distance);
+        }
+    }
+
+    template<typename F>
+    void k_closest_pairs(std::vector<point> const &points, std::size_t k, F &&report) {
+        k_closest_pairs(points.data(), points.data() + points.size(), k, std::forward<F>(report));
+    }
+
+private:
+    std::vector<point> points_;
+    std::vector<point> buffer_;
+    std::vector<closest_pair_result> heap_;
+
+    std::mt19937_64 random_;
+    point origin_;
+    unsigned long long side_ = 1;
+    unsigned int shift_ = 62;
+    std::uint32_t stamp_ = 0;       // slots with another stamp are empty
+    std::vector<detail::grid_slot> table_;
+    std::vector<detail::grid_bucket> buckets_;
+
+    [[nodiscard]] unsigned long long cell(long long v, long long origin) const {
+        return ((unsigned long long) v - (unsigned long long) origin) / side_;
+    }
+
+    [[nodiscard]] std::size_t slot(unsigned long long cx, unsigned long long cy) const {
+        std::size_t mask = table_.size() - 1;
+        std::size_t h = ((cx * 0x9e3779b97f4a7c15ull) ^ ((cy + 0x632be59bd9b4e019ull) * 0xbf58476d1ce4e5b9ull)) >> shift_;
+        while (table_[h].stamp == stamp_ && (buckets_[table_[h].bucket].cx != cx || buckets_[table_[h].bucket].cy != cy)) {
+            h = (h + 1) & mask;
+        }
+        return h;
+    }
+
+    void insert(point const &p, unsigned long long cx, unsigned long long cy) {
+        detail::grid_slot &s = table_[slot(cx, cy)];
+        if (s.stamp != stamp_) {
+            s = {stamp_, std::uint32_t(buckets_.size())};
+            buckets_.push_back({{}, {}, cx, cy, 0});
+        }
+        detail::grid_bucket &b = buckets_[s.bucket];
+        b.x[b.size] = p.x;
+        b.y[b.size] = p.y;
+        b.size++;
+    }
+
+    /*
+     * Grid of the first count points with cells for the squared distance sqr_dist.
+     */
+    void rebuild(std::size_t count, unsigned long long sqr_dist) {
+        side_ = detail::closest_pair_state::reach_of(sqr_dist);
+        if (++stamp_ == 0) {
+            std::fill(table_.begin(), table_.end(), detail::grid_slot{0, 0});
+            stamp_ = 1;
+        }
+        buckets_.clear();
+        for (std::size_t i = 0; i < count; i++) {
+            insert(points_[i], cell(points_[i].x, origin_.x), cell(points_[i].y, origin_.y));
+        }
+    }
+
+    static bool by_x(point const &p1, point const &p2) {
+        return p1.x < p2.x;
+    }
+
+    static std::uint64_t random_seed() {
+        std::random_device device;
+        return (std::uint64_t) device() << 32 ^ device();
+    }
+
+    void load(point const *first, point const *last) {
+        points_.assign(first, last);
+        buffer_.resize(points_.size());
+    }
+};
+
+/*
+ * Closest pair of points with a one-off engine.
+ */
+inline closest_pair_result closest_pair(std::vector<point_t<long long>> const &points,
+                                        closest_pair_method method = closest_pair_method::DIVIDE_AND_CONQUER) {
+    return closest_pair_engine().query(points, method);
+}
+
+}
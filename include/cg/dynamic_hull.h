@@ -0,0 +1,537 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "hull.h"
+#include "point.h"
+
+namespace cg {
+
+namespace detail {
+
+/*
+ * Upper hull of a dynamic multiset of points, in the style of Overmars and van Leeuwen.
+ *
+ * Points sit in the leaves of a weight-balanced tree ordered lexicographically. Every internal
+ * node keeps only the bridge of its children's upper hulls and how many hull vertices each child
+ * contributes; the hull of any subtree is implicit and is walked by following bridges down.
+ * A bridge is found in O(log n), an update recomputes the bridges on its path in O(log^2 n)
+ * (amortized, because unbalanced subtrees are rebuilt from scratch), queries take O(log n).
+ *
+ * The hull is the same strict chain as the upper chain of monotone_chains.
+ * Turns use 64-bit cross products, so coordinate spans must stay below 2^31.
+ */
+class upper_hull_tree {
+public:
+    typedef point_t<long long> point;
+
+    void insert(point const &p) {
+        if (root_ < 0) {
+            root_ = new_leaf(p);
+            return;
+        }
+        std::vector<int> path;
+        int u = descend(p, path);
+        if (nodes_[u].key == p) {
+            nodes_[u].count++;
+            return;
+        }
+        int leaf = new_leaf(p);
+        int top = lexicographic_less(nodes_[u].key, p) ? new_internal(u, leaf) : new_internal(leaf, u);
+        replace(path, u, top);
+        repair(path, p, true, 0);
+    }
+
+    /*
+     * Removes one copy of p; returns false if there is none.
+     */
+    bool erase(point const &p) {
+        if (root_ < 0) {
+            return false;
+        }
+        std::vector<int> path;
+        int u = descend(p, path);
+        if (nodes_[u].key != p) {
+            return false;
+        }
+        if (--nodes_[u].count > 0) {
+            return true;
+        }
+        std::size_t stale = path.size();
+        for (std::size_t i = path.size(); i-- > 0;) {
+            stale = i;
+            if (!used(path[i], p)) {
+                break;
+            }
+        }
+        free_.push_back(u);
+        if (path.empty()) {
+            root_ = -1;
+            return true;
+        }
+        int parent = path.back();
+        path.pop_back();
+        int sibling = nodes_[parent].left == u ? nodes_[parent].right : nodes_[parent].left;
+        replace(path, parent, sibling);
+        free_.push_back(parent);
+        for (int v : path) {
+            if (nodes_[v].key == p) {
+                nodes_[v].key = rightmost(nodes_[v].left);
+            }
+        }
+        repair(path, p, false, stale);
+        return true;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return root_ < 0;
+    }
+
+    /*
+     * Number of hull vertices.
+     */
+    [[nodiscard]] std::size_t size() const {
+        return root_ < 0 ? 0 : hull_size(root_);
+    }
+
+    /*
+     * k-th hull vertex from the lexicographically smallest one.
+     */
+    [[nodiscard]] point vertex(std::size_t k) const {
+        int u = root_;
+        while (!leaf(u)) {
+            node const &v = nodes_[u];
+            if (k < v.left_count) {
+                u = v.left;
+            } else {
+                k = k - v.left_count + hull_size(v.right) - v.right_count;
+                u = v.right;
+            }
+        }
+        return nodes_[u].key;
+    }
+
+    /*
+     * A point maximizing direction * p, for direction.y > 0 or direction = (-1, 0).
+     */
+    [[nodiscard]] point extreme(point const &direction) const {
+        int u = root_;
+        while (!leaf(u)) {
+            node const &v = nodes_[u];
+            u = direction * (v.b - v.a) > 0 ? v.right : v.left;
+        }
+        return nodes_[u].key;
+    }
+
+    /*
+     * Whether q is below or on the hull, within its x range.
+     */
+    [[nodiscard]] bool below(point const &q) const {
+        if (root_ < 0) {
+            return false;
+        }
+        int u = root_;
+        while (!leaf(u)) {
+            node const &v = nodes_[u];
+            if (q.x < v.a.x) {
+                u = v.left;
+            } else if (q.x > v.b.x) {
+                u = v.right;
+            } else if (v.a.x == v.b.x) {
+                return q.y <= v.b.y;
+            } else {
+                return orientation(v.a, v.b, q) <= 0;
+            }
+        }
+        return q.x == nodes_[u].key.x && q.y <= nodes_[u].key.y;
+    }
+
+    [[nodiscard]] std::vector<point> chain() const {
+        std::vector<point> result(size());
+        for (std::size_t k = 0; k < result.size(); k++) {
+            result[k] = vertex(k);
+        }
+        return result;
+    }
+
+private:
+    struct node {
+        point key;                  // the point for leaves, the largest point of the left subtree otherwise
+        unsigned int count;         // multiplicity of a leaf
+        int left, right;            // -1 for leaves
+        std::size_t size;           // distinct points below
+        point a, b;                 // bridge: a from the left hull, b from the right one
+        std::size_t left_count;     // left hull vertices up to a
+        std::size_t right_count;    // right hull vertices from b on
+    };
+
+    std::vector<node> nodes_;
+    std::vector<int> free_;
+    int root_ = -1;
+
+    [[nodiscard]] bool leaf(int u) const {
+        return nodes_[u].left < 0;
+    }
+
+    [[nodiscard]] std::size_t hull_size(int u) const {
+        return nodes_[u].left_count + nodes_[u].right_count;
+    }
+
+    int allocate() {
+        if (!free_.empty()) {
+            int u = free_.back();
+            free_.pop_back();
+            return u;
+        }
+        nodes_.emplace_back();
+        return int(nodes_.size()) - 1;
+    }
+
+    int new_leaf(point const &p) {
+        int u = allocate();
+        nodes_[u] = {p, 1, -1, -1, 1, p, p, 1, 0};
+        return u;
+    }
+
+    int new_internal(int l, int r) {
+        int u = allocate();
+        nodes_[u].left = l;
+        nodes_[u].right = r;
+        nodes_[u].key = rightmost(l);
+        update(u);
+        return u;
+    }
+
+    [[nodiscard]] point rightmost(int u) const {
+        while (!leaf(u)) {
+            u = nodes_[u].right;
+        }
+        return nodes_[u].key;
+    }
+
+    int descend(point const &p, std::vector<int> &path) const {
+        int u = root_;
+        while (!leaf(u)) {
+            path.push_back(u);
+            u = lexicographic_less(nodes_[u].key, p) ? nodes_[u].right : nodes_[u].left;
+        }
+        return u;
+    }
+
+    void replace(std::vector<int> const &path, int from, int to) {
+        if (path.empty()) {
+            root_ = to;
+        } else if (nodes_[path.back()].left == from) {
+            nodes_[path.back()].left = to;
+        } else {
+            nodes_[path.back()].right = to;
+        }
+    }
+
+    /*
+     * Whether lines ab and cd (not parallel) cross at x >= m.
+     */
+    static bool crosses_right_of(point const &a, point const &b, point const &c, point const &d, long long m) {
+        typedef __int128 lll;
+        lll den = cross(b - a, d - c);
+        lll num = lll(a.x - m) * den + lll(b.x - a.x) * cross(c - a, d - c);
+        return den > 0 ? num >= 0 : num <= 0;
+    }
+
+    /*
+     * Overmars-van Leeuwen bridge search: every step drops half of one of the hulls using
+     * the bridges of the current nodes, which are edges of those hulls. m separates the x ranges.
+     */
+    [[nodiscard]] std::pair<point, point> find_bridge(int l, int r, long long m) const {
+        while (!leaf(l) || !leaf(r)) {
+            node const &x = nodes_[l], &y = nodes_[r];
+            if (leaf(l)) {
+                r = orientation_sign(x.key, y.a, y.b) >= 0 ? y.right : y.left;
+            } else if (leaf(r)) {
+                l = orientation_sign(x.b, y.key, x.a) < 0 ? x.right : x.left;
+            } else if (orientation_sign(x.a, x.b, y.a) >= 0) {
+                l = x.left;
+            } else if (orientation_sign(y.a, y.b, x.b) >= 0) {
+                r = y.right;
+            } else if (crosses_right_of(x.a, x.b, y.a, y.b, m)) {
+                r = y.left;
+            } else {
+                l = x.right;
+            }
+        }
+        return {nodes_[l].key, nodes_[r].key};
+    }
+
+    /*
+     * Hull vertices of u up to p (from p on), where p is one of them.
+     */
+    [[nodiscard]] std::size_t prefix(int u, point const &p) const {
+        long long result = 1;
+        while (!leaf(u)) {
+            node const &v = nodes_[u];
+            if (!lexicographic_less(v.key, p)) {
+                u = v.left;
+            } else {
+                result += (long long) hull_size(u) - (long long) hull_size(v.right);
+                u = v.right;
+            }
+        }
+        return result;
+    }
+
+    [[nodiscard]] std::size_t suffix(int u, point const &p) const {
+        long long result = 1;
+        while (!leaf(u)) {
+            node const &v = nodes_[u];
+            if (lexicographic_less(v.key, p)) {
+                u = v.right;
+            } else {
+                result += (long long) hull_size(u) - (long long) hull_size(v.left);
+                u = v.left;
+            }
+        }
+        return result;
+    }
+
+    void update(int u) {
+        node &v = nodes_[u];
+        v.size = nodes_[v.left].size + nodes_[v.right].size;
+        std::pair<point, point> bridge = find_bridge(v.left, v.right, v.key.x);
+        v.a = bridge.first;
+        v.b = bridge.second;
+        v.left_count = prefix(v.left, v.a);
+        v.right_count = suffix(v.right, v.b);
+    }
+
+    [[nodiscard]] bool balanced(int u) const {
+        node const &v = nodes_[u];
+        return 4 * std::max(nodes_[v.left].size, nodes_[v.right].size) <= 3 * v.size;
+    }
+
+    /*
+     * Whether p, stored below u, is within the part of a child hull that u's hull keeps.
+     */
+    [[nodiscard]] bool used(int u, point const &p) const {
+        node const &v = nodes_[u];
+        return lexicographic_less(v.key, p) ? !lexicographic_less(p, v.b) : !lexicographic_less(v.a, p);
+    }
+
+    [[nodiscard]] bool on_hull(int u, point const &p) const {
+        while (!leaf(u)) {
+            if (!used(u, p)) {
+                return false;
+            }
+            u = lexicographic_less(nodes_[u].key, p) ? nodes_[u].right : nodes_[u].left;
+        }
+        return true;
+    }
+
+    /*
+     * Fixes a root-to-leaf path after p was inserted or removed below it: sizes first, then the
+     * topmost unbalanced node is rebuilt and bridges are recomputed bottom-up. A bridge depends only
+     * on the children's hulls, so this stops once p is not a vertex of the changed child's hull.
+     * For an insertion that is read from the new bridges; for a removal the caller checks the old
+     * ones beforehand, and nodes above stale are left alone.
+     */
+    void repair(std::vector<int> const &path, point const &p, bool inserted, std::size_t stale) {
+        for (std::size_t i = path.size(); i-- > 0;) {
+            nodes_[path[i]].size = nodes_[nodes_[path[i]].left].size + nodes_[nodes_[path[i]].right].size;
+        }
+        std::size_t from = path.size();
+        bool changed = true;
+        for (std::size_t i = 0; i < path.size(); i++) {
+            if (!balanced(path[i])) {
+                std::vector<int> above(path.begin(), path.begin() + i);
+                int root = rebuild(path[i]);
+                replace(above, path[i], root);
+                from = i;
+                changed = !inserted || on_hull(root, p);
+                break;
+            }
+        }
+        for (std::size_t i = from; i-- > stale && changed;) {
+            update(path[i]);
+            changed = !inserted || used(path[i], p);
+        }
+    }
+
+    int rebuild(int u) {
+        std::vector<int> leaves;
+        collect(u, leaves);
+        return build(leaves, 0, leaves.size());
+    }
+
+    void collect(int u, std::vector<int> &leaves) {
+        if (leaf(u)) {
+            leaves.push_back(u);
+            return;
+        }
+        collect(nodes_[u].left, leaves);
+        collect(nodes_[u].right, leaves);
+        free_.push_back(u);
+    }
+
+    int build(std::vector<int> const &leaves, std::size_t from, std::size_t to) {
+        if (to - from == 1) {
+            return leaves[from];
+        }
+        std::size_t middle = (from + to) / 2;
+        int l = build(leaves, from, middle);
+        int r = build(leaves, middle, to);
+        return new_internal(l, r);
+    }
+};
+
+}
+
+/*
+ * Convex hull of a multiset of points under insertions and deletions.
+ * The upper hull is kept for the points and the lower one as the upper hull of the reflected
+ * points (-p), so the lexicographic order is just reversed.
+ */
+class dynamic_hull {
+public:
+    typedef point_t<long long> point;
+
+    void insert(point const &p) {
+        upper_.insert(p);
+        lower_.insert(-p);
+        points_++;
+    }
+
+    /*
+     * Removes one copy of p; returns false if there is none.
+     */
+    bool erase(point const &p) {
+        if (!upper_.erase(p)) {
+            return false;
+        }
+        lower_.erase(-p);
+        points_--;
+        return true;
+    }
+
+    /*
+     * Number of inserted points, with multiplicities.
+     */
+    [[nodiscard]] std::size_t points() const {
+        return points_;
+    }
+
+    /*
+     * Number of vertices of the strictly convex hull.
+     */
+    [[nodiscard]] std::size_t size() const {
+        std::size_t vertices = upper_.size() + lower_.size();
+        return vertices <= 2 ? vertices / 2 : vertices - 2;
+    }
+
+    /*
+     * A hull vertex maximizing direction * p; the hull must not be empty.
+     */
+    [[nodiscard]] point extreme(point const &direction) const {
+        if (direction.y > 0 || (direction.y == 0 && direction.x < 0)) {
+            return upper_.extreme(direction);
+        }
+        return -lower_.extreme(-direction);
+    }
+
+    /*
+     * Whether q lies in the closed hull.
+     */
+    [[nodiscard]] bool contains(point const &q) const {
+        return upper_.below(q) && lower_.below(-q);
+    }
+
+    /*
+     * Tangent vertices from q, which must lie strictly outside the hull: the whole hull is
+     * on the left of (or on) the ray q -> first and on the right of (or on) q -> second.
+     * Collinear ties go to the farthest vertex.
+     */
+    [[nodiscard]] std::pair<point, point> tangents(point const &q) const {
+        std::vector<point> candidates;
+        tangent_candidates(upper_, q, 1, candidates);
+        tangent_candidates(lower_, -q, -1, candidates);
+        std::pair<point, point> result(candidates[0], candidates[0]);
+        for (point const &p : candidates) {
+            int rotate = orientation_sign(q, result.first, p);
+            if (rotate < 0 || (rotate == 0 && (p - q).sqr_length() > (result.first - q).sqr_length())) {
+                result.first = p;
+            }
+            rotate = orientation_sign(q, result.second, p);
+            if (rotate > 0 || (rotate == 0 && (p - q).sqr_length() > (result.second - q).sqr_length())) {
+                result.second = p;
+            }
+        }
+        return result;
+    }
+
+    /*
+     * The hull in the same format as convex_hull.
+     */
+    [[nodiscard]] std::vector<point> hull() const {
+        if (points_ == 0) {
+            return {};
+        }
+        detail::hull_chains chains;
+        chains.upper = upper_.chain();
+        chains.lower = lower_.chain();
+        for (point &p : chains.lower) {
+            p = -p;
+        }
+        std::reverse(chains.lower.begin(), chains.lower.end());
+        return detail::graham_order(chains, points_);
+    }
+
+private:
+    detail::upper_hull_tree upper_, lower_;
+    std::size_t points_ = 0;
+
+    /*
+     * Splits the chain into vertices left of q.x, at q.x and right of it: on each side the turn
+     * of q with consecutive vertices changes sign at most once, so binary search finds the local
+     * tangent of each side.
+     */
+    static void tangent_candidates(detail::upper_hull_tree const &tree, point const &q, long long reflect,
+                                   std::vector<point> &candidates) {
+        std::size_t n = tree.size();
+        auto split = [&tree, &q, n](bool inclusive) {
+            std::size_t l = 0, r = n;
+            while (l < r) {
+                std::size_t m = (l + r) / 2;
+                long long x = tree.vertex(m).x;
+                if (x < q.x || (inclusive && x == q.x)) {
+                    l = m + 1;
+                } else {
+                    r = m;
+                }
+            }
+            return l;
+        };
+        std::size_t bounds[4] = {0, split(false), split(true), n};
+        for (unsigned int side = 0; side < 3; side++) {
+            std::size_t from = bounds[side], to = bounds[side + 1];
+            if (from == to) {
+                continue;
+            }
+            int first = orientation_sign(q, tree.vertex(from), tree.vertex(std::min(from + 1, to - 1)));
+            std::size_t lo = from, hi = to - 1;
+            while (lo < hi) {
+                std::size_t m = (lo + hi) / 2;
+                if (orientation_sign(q, tree.vertex(m), tree.vertex(m + 1)) != first) {
+                    hi = m;
+                } else {
+                    lo = m + 1;
+                }
+            }
+            for (std::size_t k : {from, to - 1, lo, lo > from ? lo - 1 : lo, std::min(lo + 1, to - 1)}) {
+                candidates.push_back(tree.vertex(k) * reflect);
+            }
+        }
+    }
+};
+
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "parallel.h"
+#include "point_location.h"
+
+namespace cg {
+
+/*
+ * Polygons containing points[i]: id[offset[i], offset[i + 1]), in increasing order.
+ */
+struct geofence_hits {
+    std::vector<std::size_t> offset;
+    std::vector<std::uint32_t> id;
+};
+
+/*
+ * Which of many simple polygons contain a point, with the semantics of polygon_locator: a point
+ * on an edge is contained.
+ *
+ * A uniform grid covers all bounding boxes; the cell side is chosen for about as many cells as
+ * vertices, with no more than that along either axis however thin the layout, and large enough
+ * that the boxes cover about four cells per vertex. Every cell lists
+ * the polygons it meets: a cell touched by no edge of a polygon is wholly inside it or outside,
+ * known at build time, and outside ones are not listed, so only cells crossed by edges query
+ * the polygon's locator.
+ */
+class geofence_index {
+public:
+    typedef point_t<long long> point;
+
+    explicit geofence_index(std::vector<std::vector<point>> const &polygons) {
+        std::size_t vertices = 0;
+        long double area = 0;
+        lo_ = point(std::numeric_limits<long long>::max(), std::numeric_limits<long long>::max());
+        point hi(std::numeric_limits<long long>::min(), std::numeric_limits<long long>::min());
+        for (std::vector<point> const &polygon : polygons) {
+            box b = bounds(polygon);
+            boxes_.push_back(b);
+            lo_ = point(std::min(lo_.x, b.lo.x), std::min(lo_.y, b.lo.y));
+            hi = point(std::max(hi.x, b.hi.x), std::max(hi.y, b.hi.y));
+            vertices += polygon.size();
+            area += ((long double) b.hi.x - b.lo.x + 1) * ((long double) b.hi.y - b.lo.y + 1);
+            locators_.emplace_back(polygon);
+        }
+        if (polygons.empty()) {
+            lo_ = hi = point();
+        }
+        long double w = (long double) hi.x - lo_.x + 1, h = (long double) hi.y - lo_.y + 1;
+        long double cells = (long double) std::max<std::size_t>(vertices, 1);
+        long double side = std::max(std::sqrt(std::max(w * h / cells, area / (4 * cells))), std::max(w, h) / cells);
+        side_ = std::max(1LL, (long long) std::ceil(side));
+        columns_ = (std::size_t) ((hi.x - lo_.x) / side_ + 1);
+        rows_ = (std::size_t) ((hi.y - lo_.y) / side_ + 1);
+
+        std::vector<std::pair<std::size_t, std::uint32_t>> entries;
+        for (std::size_t i = 0; i < polygons.size(); i++) {
+            add(polygons[i], (std::uint32_t) i, entries);
+        }
+        start_.assign(columns_ * rows_ + 1, 0);
+        for (auto const &entry : entries) {
+            start_[entry.first + 1]++;
+        }
+        for (std::size_t c = 0; c < columns_ * rows_; c++) {
+            start_[c + 1] += start_[c];
+        }
+        std::vector<std::size_t> fill(start_.begin(), start_.end() - 1);
+        cells_.resize(entries.size());
+        for (auto const &entry : entries) {
+            cells_[fill[entry.first]++] = entry.second;
+        }
+    }
+
+    /*
+     * Calls report(id) for every polygon containing p, in increasing order of id.
+     */
+    template<typename F>
+    void containing(point const &p, F const &report) const {
+        if (p.x < lo_.x || p.y < lo_.y) {
+            return;
+        }
+        std::size_t cx = (std::size_t) ((p.x - lo_.x) / side_), cy = (std::size_t) ((p.y - lo_.y) / side_);
+        if (cx >= columns_ || cy >= rows_) {
+            return;
+        }
+        std::size_t c = cy * columns_ + cx;
+        for (std::size_t k = start_[c]; k < start_[c + 1]; k++) {
+            std::uint32_t id = cells_[k] >> 1;
+            if ((cells_[k] & 1) == 0 || locators_[id].locate(p) != position::OUTSIDE) {
+                report(id);
+            }
+        }
+    }
+
+    [[nodiscard]] geofence_hits query(point const *points, std::size_t count) const {
+        geofence_hits result;
+        result.offset.reserve(count + 1);
+        result.offset.push_back(0);
+        for (std::size_t i = 0; i < count; i++) {
+            containing(points[i], [&result](std::uint32_t id) {
+                result.id.push_back(id);
+            });
+            result.offset.push_back(result.id.size());
+        }
+        return result;
+    }
+
+    /*
+     * The same batch in contiguous chunks on the pool, joined in order.
+     */
+    [[nodiscard]] geofence_hits query(point const *points, std::size_t count, thread_pool &pool) const {
+        std::size_t chunks = std::max<std::size_t>(1, std::min<std::size_t>(4 * pool.size(), count / 1024));
+        std::vector<geofence_hits> parts(chunks);
+        auto bound = [count, chunks](std::size_t i) {
+            return count * i / chunks;
+        };
+        parallel_for(pool, chunks, [&](std::size_t i) {
+            parts[i] = query(points + bound(i), bound(i + 1) - bound(i));
+        });
+        std::vector<std::size_t> base(chunks + 1, 0);
+        for (std::size_t i = 0; i < chunks; i++) {
+            base[i + 1] = base[i] + parts[i].id.size();
+        }
+        geofence_hits result;
+        result.offset.resize(count + 1);
+        result.id.resize(base[chunks]);
+        result.offset[count] = base[chunks];
+        parallel_for(pool, chunks, [&](std::size_t i) {
+            for (std::size_t j = 0; j < bound(i + 1) - bound(i); j++) {
+                result.offset[bound(i) + j] = base[i] + parts[i].offset[j];
+            }
+            std::copy(parts[i].id.begin(), parts[i].id.end(), result.id.begin() + base[i]);
+        });
+        return result;
+    }
+
+private:
+    struct box {
+        point lo;
+        point hi;
+    };
+
+    std::vector<box> boxes_;
+    std::vector<polygon_locator> locators_;
+    point lo_;
+    long long side_;
+    std::size_t columns_, rows_;
+    std::vector<std::size_t> start_;        // cells_[start_[c], start_[c + 1]) for cell c, row by row
+    std::vector<std::uint32_t> cells_;      // id << 1 | whether the cell is crossed by an edge
+
+    static box bounds(std::vector<point> const &polygon) {
+        box b{polygon[0], polygon[0]};
+        for (point const &p : polygon) {
+            b.lo = point(std::min(b.lo.x, p.x), std::min(b.lo.y, p.y));
+            b.hi = point(std::max(b.hi.x, p.x), std::max(b.hi.y, p.y));
+        }
+        return b;
+    }
+
+    [[nodiscard]] std::size_t column(long long x) const {
+        return (std::size_t) ((x - lo_.x) / side_);
+    }
+
+    [[nodiscard]] std::size_t row(long long y) const {
+        return (std::size_t) ((y - lo_.y) / side_);
+    }
+
+    /*
+     * Lists polygon id in the cells of its bounding box that it meets. Cells crossed by an edge are
+     * found column by column from the edge's ordinates at the column sides, widened by one unit
+     * against rounding, so that they are a superset of the exact ones.
+     */
+    void add(std::vector<point> const &polygon, std::uint32_t id, std::vector<std::pair<std::size_t, std::uint32_t>> &entries) const {
+        box const &b = boxes_[id];
+        std::size_t x0 = column(b.lo.x), y0 = row(b.lo.y);
+        std::size_t width = column(b.hi.x) - x0 + 1, height = row(b.hi.y) - y0 + 1;
+        std::vector<char> crossed(width * height, 0);
+        for (std::size_t i = 0; i < polygon.size(); i++) {
+            point p1 = polygon[i], p2 = polygon[(i + 1) % polygon.size()];
+            if (p2.x < p1.x) {
+                std::swap(p1, p2);
+            }
+            for (std::size_t cx = column(p1.x); cx <= column(p2.x); cx++) {
+                long long left = std::max(p1.x, lo_.x + (long long) cx * side_);
+                long long right = std::min(p2.x, lo_.x + (long long) (cx + 1) * side_);
+                long long low = std::min(p1.y, p2.y), high = std::max(p1.y, p2.y);
+                if (p1.x != p2.x) {
+                    long double slope = ((long double) p2.y - p1.y) / ((long double) p2.x - p1.x);
+                    long double ya = p1.y + slope * (left - p1.x), yb = p1.y + slope * (right - p1.x);
+                    low = std::max(low, (long long) std::floor(std::min(ya, yb)) - 1);
+                    high = std::min(high, (long long) std::ceil(std::max(ya, yb)) + 1);
+                }
+                for (std::size_t cy = row(low); cy <= row(high); cy++) {
+                    crossed[(cy - y0) * width + (cx - x0)] = 1;
+                }
+            }
+        }
+        for (std::size_t cy = 0; cy < height; cy++) {
+            for (std::size_t cx = 0; cx < width; cx++) {
+                std::size_t c = (y0 + cy) * columns_ + x0 + cx;
+                if (crossed[cy * width + cx]) {
+                    entries.emplace_back(c, id << 1 | 1);
+                } else {
+                    point corner(lo_.x + (long long) (x0 + cx) * side_, lo_.y + (long long) (y0 + cy) * side_);
+                    if (locators_[id].locate(corner) == position::INSIDE) {
+                        entries.emplace_back(c, id << 1);
+                    }
+                }
+            }
+        }
+    }
+};
+
+}
@@ -0,0 +1,396 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <vector>
+#include <gmpxx.h>
+
+#include "point.h"
+
+namespace cg {
+
+/*
+ * Half-plane a * x + b * y + c >= 0.
+ */
+template<typename T>
+struct semiplane_t {
+    T a;
+    T b;
+    T c;
+
+    semiplane_t() : a(0), b(0), c(0) {}
+
+    semiplane_t(T a, T b, T c) : a(a), b(b), c(c) {}
+
+    static T det(T const &a, T const &b, T const &c, T const &d) {
+        return a * d - b * c;
+    }
+
+    [[nodiscard]] point_t<T> norm() const {
+        return point_t<T>(a, b);
+    }
+
+    /*
+     * Direction of the boundary with the half-plane on its left.
+     */
+    [[nodiscard]] point_t<T> direction() const {
+        return point_t<T>(b, -a);
+    }
+
+    [[nodiscard]] int where(point_t<T> const &p) const {
+        return sign(p.x * a + p.y * b + c);
+    }
+
+    [[nodiscard]] bool parallel(semiplane_t const &other) const {
+        return det(a, b, other.a, other.b) == 0;
+    }
+
+    [[nodiscard]] bool is(semiplane_t const &other) const {
+        return det(a, b, other.a, other.b) == 0 &&
+               det(a, c, other.a, other.c) == 0 &&
+               det(b, c, other.b, other.c) == 0;
+    }
+
+    [[nodiscard]] point_t<T> intersect(semiplane_t const &other) const {
+        T alpha = det(a, b, other.a, other.b);
+        return point_t<T>(
+                det(b, c, other.b, other.c) / alpha,
+                det(c, a, other.c, other.a) / alpha
+        );
+    }
+
+    bool operator==(semiplane_t const &other) const {
+        return a == other.a && b == other.b && c == other.c;
+    }
+};
+
+/*
+ * Point (x / w, y / w), w > 0.
+ */
+template<typename T>
+struct homogeneous_point_t {
+    T x;
+    T y;
+    T w;
+
+    template<typename U>
+    [[nodiscard]] point_t<U> to() const {
+        return point_t<U>((U) (x) / (U) (w), (U) (y) / (U) (w));
+    }
+};
+
+enum class half_plane_status {
+    EMPTY,
+    BOUNDED,
+    UNBOUNDED
+};
+
+/*
+ * Intersection polygon, counter-clockwise without repeated vertices. EMPTY also covers
+ * intersections of zero area; an UNBOUNDED intersection comes clipped by the bounding box.
+ */
+template<typename T>
+struct half_plane_result {
+    half_plane_status status;
+    std::vector<point_t<T>> polygon;
+    T area;
+};
+
+/*
+ * Exact intersection: the vertices of a BOUNDED polygon and its area, nothing for the other statuses.
+ */
+struct half_plane_exact_result {
+    half_plane_status status;
+    std::vector<homogeneous_point_t<__int128>> polygon;
+    mpq_class area;
+};
+
+/*
+ * q rounded to the nearest double, ties to even; mpq_class::get_d truncates toward zero.
+ */
+inline double nearest_double(mpq_class const &q) {
+    double d = q.get_d();
+    double away = std::nextafter(d, sgn(q) < 0 ? -HUGE_VAL : HUGE_VAL);
+    if (std::isinf(away)) {
+        return d;
+    }
+    int c = cmp(abs(q - mpq_class(d)), abs(mpq_class(away) - q));
+    std::uint64_t bits;
+    std::memcpy(&bits, &away, sizeof(bits));
+    return c > 0 || (c == 0 && (bits & 1) == 0) ? away : d;
+}
+
+namespace detail {
+
+template<typename T>
+bool upper_direction(point_t<T> const &d) {
+    return d.y > 0 || (d.y == 0 && d.x > 0);
+}
+
+/*
+ * Order by the angle of the boundary direction; among parallel half-planes of the same
+ * direction the one with the innermost boundary comes first.
+ */
+template<typename T>
+bool angle_less(semiplane_t<T> const &h1, semiplane_t<T> const &h2) {
+    point_t<T> d1 = h1.direction(), d2 = h2.direction();
+    bool u1 = upper_direction(d1), u2 = upper_direction(d2);
+    if (u1 != u2) {
+        return u1;
+    }
+    T turn = cross(d1, d2);
+    if (turn != 0) {
+        return turn > 0;
+    }
+    /* same direction, n1 = k * n2 with k > 0: compare c1 / |n1| with c2 / |n2| */
+    return h1.c * (h2.norm() * h2.norm()) < h2.c * (h1.norm() * h2.norm());
+}
+
+template<typename T>
+bool same_angle(semiplane_t<T> const &h1, semiplane_t<T> const &h2) {
+    return upper_direction(h1.direction()) == upper_direction(h2.direction()) &&
+           cross(h1.direction(), h2.direction()) == 0;
+}
+
+/*
+ * Indices of all, sorted by less, keeping the first half-plane of every direction.
+ */
+template<typename T, typename Less>
+std::vector<std::size_t> angle_order(std::vector<semiplane_t<T>> const &all, Less less) {
+    std::vector<std::size_t> order(all.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), less);
+    order.erase(std::unique(order.begin(), order.end(), [&all](std::size_t i, std::size_t j) {
+        return same_angle(all[i], all[j]);
+    }), order.end());
+    return order;
+}
+
+/*
+ * Deque sweep over the sorted half-planes: deque[lo, hi) receives the sides of the intersection
+ * in counter-clockwise order, and false is returned when it is empty. outside(k, i, j) tells
+ * whether the vertex of sides i and j lies strictly outside half-plane k.
+ */
+template<typename T, typename Outside>
+bool half_plane_sweep(std::vector<semiplane_t<T>> const &all, std::vector<std::size_t> const &order,
+                      std::vector<std::size_t> &deque, std::size_t &lo, std::size_t &hi, Outside outside) {
+    deque.resize(order.size());
+    lo = hi = 0;
+    for (std::size_t k : order) {
+        while (hi - lo >= 2 && outside(k, deque[hi - 2], deque[hi - 1])) {
+            hi--;
+        }
+        while (hi - lo >= 2 && outside(k, deque[lo], deque[lo + 1])) {
+            lo++;
+        }
+        if (hi > lo && all[k].parallel(all[deque[hi - 1]])) {
+            return false;
+        }
+        deque[hi++] = k;
+    }
+    while (hi - lo >= 3 && outside(deque[lo], deque[hi - 2], deque[hi - 1])) {
+        hi--;
+    }
+    while (hi - lo >= 3 && outside(deque[hi - 1], deque[lo], deque[lo + 1])) {
+        lo++;
+    }
+    return hi - lo >= 3;
+}
+
+}
+
+/*
+ * Intersection of half-planes by sorting them by angle and sweeping a deque, O(n log n).
+ * The box |x|, |y| <= edge is added to the constraints, and the intersection is UNBOUNDED
+ * when one of its sides survives. Parallel half-planes of one direction are reduced to the
+ * innermost one before the sweep, and opposite ones meeting in the deque mean an empty result.
+ */
+template<typename T>
+half_plane_result<T> half_plane_intersection(std::vector<semiplane_t<T>> const &lines, T edge) {
+    std::size_t n = lines.size();
+    std::vector<semiplane_t<T>> all(lines);
+    all.emplace_back(1, 0, edge);
+    all.emplace_back(0, 1, edge);
+    all.emplace_back(-1, 0, edge);
+    all.emplace_back(0, -1, edge);
+
+    std::vector<std::size_t> order = detail::angle_order(all, [&all](std::size_t i, std::size_t j) {
+        return detail::angle_less(all[i], all[j]);
+    });
+    half_plane_result<T> result{half_plane_status::EMPTY, {}, 0};
+    std::vector<std::size_t> deque;
+    std::size_t lo, hi;
+    bool found = detail::half_plane_sweep(all, order, deque, lo, hi, [&all](std::size_t k, std::size_t i, std::size_t j) {
+        return all[k].where(all[i].intersect(all[j])) < 0;
+    });
+    if (!found) {
+        return result;
+    }
+
+    for (std::size_t i = lo; i < hi; i++) {
+        point_t<T> p = all[deque[i]].intersect(all[deque[i + 1 < hi ? i + 1 : lo]]);
+        if (result.polygon.empty() || (p != result.polygon.back() && p != result.polygon.front())) {
+            result.polygon.push_back(p);
+        }
+    }
+    for (std::size_t i = 0; i < result.polygon.size(); i++) {
+        result.area += cross(result.polygon[i], result.polygon[(i + 1) % result.polygon.size()]);
+    }
+    result.area /= 2;
+    if (result.polygon.size() < 3 || result.area <= 0) {
+        result.polygon.clear();
+        result.area = 0;
+        return result;
+    }
+    bool bounded = std::all_of(deque.begin() + lo, deque.begin() + hi, [n](std::size_t k) {
+        return k < n;
+    });
+    result.status = bounded ? half_plane_status::BOUNDED : half_plane_status::UNBOUNDED;
+    return result;
+}
+
+/*
+ * Coefficients of the exact mode are bounded by 2^40, so that every predicate fits into 128 bits.
+ */
+constexpr long long half_plane_exact_limit = 1LL << 40;
+
+namespace detail {
+
+/*
+ * Vertex ((x1 * E + x0) / w, (y1 * E + y0) / w) of two sides, where E is the edge of the bounding
+ * box, symbolically larger than any coordinate.
+ */
+struct symbolic_vertex {
+    __int128 x1, x0;
+    __int128 y1, y0;
+    __int128 w;
+};
+
+inline mpz_class to_mpz(__int128 value) {
+    unsigned __int128 magnitude = value < 0 ? -(unsigned __int128) value : (unsigned __int128) value;
+    mpz_class result = (unsigned long) (magnitude >> 64);
+    result <<= 64;
+    result += (unsigned long) magnitude;
+    return value < 0 ? mpz_class(-result) : result;
+}
+
+/*
+ * Sum of the fractions num[i] / den[i] in num[0] / den[0], added pairwise so that the operands of
+ * every step are of about the same size.
+ */
+inline void fraction_sum(std::vector<mpz_class> &num, std::vector<mpz_class> &den) {
+    for (std::size_t step = 1; step < num.size(); step *= 2) {
+        for (std::size_t i = 0; i + step < num.size(); i += 2 * step) {
+            num[i] = num[i] * den[i + step] + num[i + step] * den[i];
+            den[i] *= den[i + step];
+        }
+    }
+}
+
+}
+
+/*
+ * The same intersection, exact for integer coefficients below half_plane_exact_limit. Sides are
+ * kept as 128-bit integer coefficients and vertices as homogeneous 128-bit points; the bounding box
+ * is symbolic, so boundedness does not depend on its size, and the area is an exact rational.
+ */
+template<typename T>
+half_plane_exact_result half_plane_intersection_exact(std::vector<semiplane_t<T>> const &lines) {
+    typedef __int128 lll;
+    typedef semiplane_t<lll> semiplane;
+    std::size_t n = lines.size();
+    std::vector<semiplane> all;
+    all.reserve(n + 4);
+    for (semiplane_t<T> const &h : lines) {
+        all.emplace_back(h.a, h.b, h.c);
+    }
+    /* box sides x <= E, y <= E, x >= -E, y >= -E, with c = E implied */
+    all.emplace_back(-1, 0, 0);
+    all.emplace_back(0, -1, 0);
+    all.emplace_back(1, 0, 0);
+    all.emplace_back(0, 1, 0);
+
+    std::vector<std::size_t> order = detail::angle_order(all, [&all, n](std::size_t i, std::size_t j) {
+        if ((i < n) != (j < n) && detail::same_angle(all[i], all[j])) {
+            return i < n;
+        }
+        return detail::angle_less(all[i], all[j]);
+    });
+    auto vertex = [&all, n](std::size_t i, std::size_t j) {
+        semiplane const &p = all[i], &q = all[j];
+        lll e1 = i >= n, e2 = j >= n;
+        return detail::symbolic_vertex{p.b * e2 - q.b * e1, p.b * q.c - q.b * p.c,
+                                       e1 * q.a - e2 * p.a, p.c * q.a - q.c * p.a,
+                                       p.a * q.b - q.a * p.b};
+    };
+    auto where = [&all, n](std::size_t k, detail::symbolic_vertex const &v) {
+        semiplane const &h = all[k];
+        lll far = h.a * v.x1 + h.b * v.y1 + (k >= n ? v.w : 0);
+        lll near = h.a * v.x0 + h.b * v.y0 + h.c * v.w;
+        return sign(far != 0 ? far : near) * sign(v.w);
+    };
+
+    half_plane_exact_result result{half_plane_status::EMPTY, {}, 0};
+    std::vector<std::size_t> deque;
+    std::size_t lo, hi;
+    bool found = detail::half_plane_sweep(all, order, deque, lo, hi, [&](std::size_t k, std::size_t i, std::size_t j) {
+        return where(k, vertex(i, j)) < 0;
+    });
+    if (!found) {
+        return result;
+    }
+
+    /* vertex (i, i + 1) of the deque, repeated ones dropped; two vertices are equal when one lies on both sides of the other */
+    std::vector<std::size_t> corners;
+    auto next = [lo, hi](std::size_t i) {
+        return i + 1 < hi ? i + 1 : lo;
+    };
+    auto same = [&](std::size_t i, std::size_t j) {
+        detail::symbolic_vertex v = vertex(deque[i], deque[next(i)]);
+        return where(deque[j], v) == 0 && where(deque[next(j)], v) == 0;
+    };
+    for (std::size_t i = lo; i < hi; i++) {
+        if (corners.empty() || (!same(i, corners.back()) && !same(i, corners.front()))) {
+            corners.push_back(i);
+        }
+    }
+    if (corners.size() < 3) {
+        return result;
+    }
+    bool bounded = std::all_of(deque.begin() + lo, deque.begin() + hi, [n](std::size_t k) {
+        return k < n;
+    });
+    if (!bounded) {
+        result.status = half_plane_status::UNBOUNDED;
+        return result;
+    }
+
+    for (std::size_t i : corners) {
+        detail::symbolic_vertex v = vertex(deque[i], deque[next(i)]);
+        lll s = v.w < 0 ? -1 : 1;
+        result.polygon.push_back({v.x0 * s, v.y0 * s, v.w * s});
+    }
+    std::size_t m = result.polygon.size();
+    std::vector<mpz_class> num(m), den(m);
+    for (std::size_t i = 0; i < m; i++) {
+        homogeneous_point_t<lll> const &p = result.polygon[i], &q = result.polygon[(i + 1) % m];
+        num[i] = detail::to_mpz(p.x) * detail::to_mpz(q.y) - detail::to_mpz(p.y) * detail::to_mpz(q.x);
+        den[i] = detail::to_mpz(p.w) * detail::to_mpz(q.w);
+    }
+    detail::fraction_sum(num, den);
+    result.area = mpq_class(num[0], 2 * den[0]);
+    result.area.canonicalize();
+    if (result.area <= 0) {
+        result.polygon.clear();
+        result.area = 0;
+        return result;
+    }
+    result.status = half_plane_status::BOUNDED;
+    return result;
+}
+
+}
@@ -0,0 +1,488 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "point.h"
+#include "parallel.h"
+#include "predicates.h"
+#include "radix_sort.h"
+#include "simd.h"
+
+namespace cg {
+
+namespace detail {
+
+/*
+ * Polygon through the extreme input points in eight directions (x, y, x + y, x - y),
+ * stored as edges a + t * d. A point strictly to the left of every edge lies strictly
+ * inside the convex hull of those extreme points and cannot be a hull vertex.
+ */
+struct octagon {
+    unsigned int size;
+    double ax[8], ay[8];
+    double dx[8], dy[8];
+};
+
+/*
+ * Pruning works on doubles, so it is only done when every coordinate converts exactly
+ * (the AVX2 conversion trick needs |v| < 2^51).
+ */
+constexpr long long prune_range = 1ll << 51;
+
+inline bool make_octagon(point_t<long long> const *points, std::size_t n, octagon &result) {
+    typedef long long ll;
+    bool in_range = true;
+    for (std::size_t i = 0; i < n; i++) {
+        in_range &= -prune_range < points[i].x && points[i].x < prune_range &&
+                    -prune_range < points[i].y && points[i].y < prune_range;
+    }
+    if (!in_range || n < 3) {
+        return false;
+    }
+    /* counter-clockwise directions: -y, x - y, x, x + y, y, y - x, -x, -x - y */
+    static int const kx[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+    static int const ky[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+    std::size_t best[8] = {};
+    ll value[8];
+    for (unsigned int k = 0; k < 8; k++) {
+        value[k] = kx[k] * points[0].x + ky[k] * points[0].y;
+    }
+    for (std::size_t i = 1; i < n; i++) {
+        for (unsigned int k = 0; k < 8; k++) {
+            ll v = kx[k] * points[i].x + ky[k] * points[i].y;
+            best[k] = v > value[k] ? i : best[k];
+            value[k] = std::max(value[k], v);
+        }
+    }
+
+    point_t<long long> vertices[8];
+    unsigned int size = 0;
+    for (unsigned int k = 0; k < 8; k++) {
+        if (size == 0 || vertices[size - 1] != points[best[k]]) {
+            vertices[size++] = points[best[k]];
+        }
+    }
+    while (size > 1 && vertices[size - 1] == vertices[0]) {
+        size--;
+    }
+    if (size < 3) {
+        return false;
+    }
+    result.size = size;
+    for (unsigned int k = 0; k < size; k++) {
+        point_t<long long> const &a = vertices[k], &b = vertices[(k + 1) % size];
+        result.ax[k] = a.x;
+        result.ay[k] = a.y;
+        result.dx[k] = double(b.x) - double(a.x);
+        result.dy[k] = double(b.y) - double(a.y);
+    }
+    return true;
+}
+
+/*
+ * Every prune_* pass moves the points not certainly inside to the front, starting at kept,
+ * and returns the new kept count. Orientations are evaluated in doubles with the orient2d error
+ * bound, so a point is only dropped when it is provably inside; rounding can only keep extra points.
+ */
+inline std::size_t prune_scalar(octagon const &o, point_t<long long> *points,
+                                std::size_t from, std::size_t to, std::size_t kept) {
+    for (std::size_t i = from; i < to; i++) {
+        point_t<long long> p = points[i];
+        double x = p.x, y = p.y;
+        bool inside = true;
+        for (unsigned int k = 0; k < o.size; k++) {
+            double left = o.dx[k] * (y - o.ay[k]);
+            double right = o.dy[k] * (x - o.ax[k]);
+            inside &= left - right > ccw_bound * (std::fabs(left) + std::fabs(right));
+        }
+        points[kept] = p;
+        kept += !inside;
+    }
+    return kept;
+}
+
+inline std::size_t compact(point_t<long long> *points, std::size_t from, unsigned int width,
+                           unsigned int keep, std::size_t kept) {
+    for (unsigned int lane = 0; lane < width; lane++) {
+        points[kept] = points[from + lane];
+        kept += (keep >> lane) & 1;
+    }
+    return kept;
+}
+
+#if CG_X86_SIMD
+
+/*
+ * Exact for |v| < 2^51: the integer is added to the mantissa of 1.5 * 2^52.
+ */
+CG_TARGET_AVX2 inline __m256d avx2_to_double(__m256i v) {
+    __m256d const magic = _mm256_set1_pd(6755399441055744.0);
+    return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_add_epi64(v, _mm256_castpd_si256(magic))), magic);
+}
+
+CG_TARGET_AVX2 inline std::size_t prune_avx2(octagon const &o, point_t<long long> *points, std::size_t n) {
+    __m256d const abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    __m256d const bound = _mm256_set1_pd(ccw_bound);
+    std::size_t i = 0, kept = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(points + i));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(points + i + 2));
+        __m256d x = avx2_to_double(_mm256_permute4x64_epi64(_mm256_unpacklo_epi64(lo, hi), 0xd8));
+        __m256d y = avx2_to_double(_mm256_permute4x64_epi64(_mm256_unpackhi_epi64(lo, hi), 0xd8));
+        __m256d inside = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        for (unsigned int k = 0; k < o.size; k++) {
+            __m256d left = _mm256_mul_pd(_mm256_set1_pd(o.dx[k]), _mm256_sub_pd(y, _mm256_set1_pd(o.ay[k])));
+            __m256d right = _mm256_mul_pd(_mm256_set1_pd(o.dy[k]), _mm256_sub_pd(x, _mm256_set1_pd(o.ax[k])));
+            __m256d error = _mm256_mul_pd(bound, _mm256_add_pd(_mm256_and_pd(left, abs_mask),
+                                                               _mm256_and_pd(right, abs_mask)));
+            inside = _mm256_and_pd(inside, _mm256_cmp_pd(_mm256_sub_pd(left, right), error, _CMP_GT_OQ));
+        }
+        kept = compact(points, i, 4, ~_mm256_movemask_pd(inside) & 0xf, kept);
+    }
+    return prune_scalar(o, points, i, n, kept);
+}
+
+CG_TARGET_AVX512 inline std::size_t prune_avx512(octagon const &o, point_t<long long> *points, std::size_t n) {
+    __m512i const even = _mm512_set_epi64(14, 12, 10, 8, 6, 4, 2, 0);
+    __m512i const odd = _mm512_set_epi64(15, 13, 11, 9, 7, 5, 3, 1);
+    __m512d const bound = _mm512_set1_pd(ccw_bound);
+    std::size_t i = 0, kept = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512i lo = _mm512_loadu_si512(points + i);
+        __m512i hi = _mm512_loadu_si512(points + i + 4);
+        __m512d x = _mm512_cvtepi64_pd(_mm512_permutex2var_epi64(lo, even, hi));
+        __m512d y = _mm512_cvtepi64_pd(_mm512_permutex2var_epi64(lo, odd, hi));
+        __mmask8 inside = 0xff;
+        for (unsigned int k = 0; k < o.size; k++) {
+            __m512d left = _mm512_mul_pd(_mm512_set1_pd(o.dx[k]), _mm512_sub_pd(y, _mm512_set1_pd(o.ay[k])));
+            __m512d right = _mm512_mul_pd(_mm512_set1_pd(o.dy[k]), _mm512_sub_pd(x, _mm512_set1_pd(o.ax[k])));
+            __m512d error = _mm512_mul_pd(bound, _mm512_add_pd(_mm512_abs_pd(left), _mm512_abs_pd(right)));
+            inside &= _mm512_cmp_pd_mask(_mm512_sub_pd(left, right), error, _CMP_GT_OQ);
+        }
+        kept = compact(points, i, 8, ~inside & 0xffu, kept);
+    }
+    return prune_scalar(o, points, i, n, kept);
+}
+
+#endif
+
+}
+
+/*
+ * Akl-Toussaint heuristic: drops the points lying strictly inside the octagon of extreme points.
+ * Hull vertices always survive, so every hull function gives the same result on the remaining points.
+ */
+inline void akl_toussaint(std::vector<point_t<long long>> &points, simd_level level) {
+    detail::octagon o;
+    if (!detail::make_octagon(points.data(), points.size(), o)) {
+        return;
+    }
+    std::size_t kept;
+    switch (level) {
+#if CG_X86_SIMD
+        case simd_level::AVX512:
+            kept = detail::prune_avx512(o, points.data(), points.size());
+            break;
+        case simd_level::AVX2:
+            kept = detail::prune_avx2(o, points.data(), points.size());
+            break;
+#endif
+        default:
+            kept = detail::prune_scalar(o, points.data(), 0, points.size(), 0);
+    }
+    points.resize(kept);
+}
+
+inline void akl_toussaint(std::vector<point_t<long long>> &points) {
+    akl_toussaint(points, detect_simd());
+}
+
+/*
+ * Graham scan around the lowest (then rightmost) point.
+ * Returns the strictly convex hull counter-clockwise starting from that point;
+ * reorders the input and drops interior points from it.
+ */
+inline std::vector<point_t<long long>> convex_hull(std::vector<point_t<long long>> &points) {
+    typedef long long ll;
+    typedef unsigned long long ull;
+    typedef point_t<ll> point;
+
+    akl_toussaint(points);
+
+    point p = *min_element(points.begin(), points.end(), [](point const &p1, point const &p2) {
+        return p1.y < p2.y || (p1.y == p2.y && p1.x > p2.x);
+    });
+    sort(points.begin(), points.end(), [&p](point const &p1, point const &p2) {
+        ll rotate = (p1 - p) / (p2 - p);
+        return rotate > 0 || (rotate == 0 && (p1 - p).to<ull>().sqr_length() < (p2 - p).to<ull>().sqr_length());
+    });
+    std::vector<point> result{p};
+    for (unsigned int i = 1; i < points.size(); i++) {
+        point next = points[i];
+        while (result.size() >= 2) {
+            point v_prev = result.back() - result[result.size() - 2];
+            point v_next = next - result.back();
+            ll rotate = v_next / v_prev;
+            if (rotate >= 0) {
+                result.pop_back();
+            } else {
+                break;
+            }
+        }
+        result.push_back(next);
+    }
+    return result;
+}
+
+namespace detail {
+
+inline bool lexicographic_less(point_t<long long> const &p1, point_t<long long> const &p2) {
+    return p1.x < p2.x || (p1.x == p2.x && p1.y < p2.y);
+}
+
+/*
+ * Both chains go from the lexicographically smallest point to the largest one:
+ * the lower one turning counter-clockwise, the upper one clockwise.
+ */
+struct hull_chains {
+    std::vector<point_t<long long>> lower;
+    std::vector<point_t<long long>> upper;
+};
+
+/*
+ * Exact orientation sign for any 64-bit coordinates: differences are taken in 128 bits,
+ * products are compared by sign and unsigned 128-bit magnitude.
+ */
+inline int orientation_sign_wide(point_t<long long> const &top, point_t<long long> const &a,
+                                 point_t<long long> const &b) {
+    typedef __int128 lll;
+    typedef unsigned __int128 ulll;
+    auto product = [](lll u, lll v, ulll &magnitude) {
+        magnitude = ulll(u < 0 ? -u : u) * ulll(v < 0 ? -v : v);
+        return sign(u) * sign(v);
+    };
+    ulll left, right;
+    int left_sign = product(lll(a.x) - top.x, lll(b.y) - top.y, left);
+    int right_sign = product(lll(a.y) - top.y, lll(b.x) - top.x, right);
+    if (left_sign != right_sign) {
+        return left_sign != 0 ? left_sign : -right_sign;
+    }
+    return left_sign * ((left > right) - (left < right));
+}
+
+/*
+ * Andrew's monotone chain over lexicographically sorted points, both chains in one pass.
+ * orient(top, a, b) gives the sign of the turn.
+ */
+template<typename It, typename Orientation>
+hull_chains monotone_chains(It first, It last, Orientation orient) {
+    hull_chains result;
+    std::vector<point_t<long long>> &lower = result.lower, &upper = result.upper;
+    for (It it = first; it != last; ++it) {
+        while (lower.size() >= 2 && orient(lower[lower.size() - 2], lower.back(), *it) <= 0) {
+            lower.pop_back();
+        }
+        lower.push_back(*it);
+        while (upper.size() >= 2 && orient(upper[upper.size() - 2], upper.back(), *it) >= 0) {
+            upper.pop_back();
+        }
+        upper.push_back(*it);
+    }
+    return result;
+}
+
+template<typename It>
+hull_chains monotone_chains(It first, It last) {
+    return monotone_chains(first, last, [](point_t<long long> const &top, point_t<long long> const &a,
+                                           point_t<long long> const &b) {
+        return orientation(top, a, b);
+    });
+}
+
+/*
+ * Joins chains of two lexicographically separated point sets along their common tangent.
+ * turn is +1 for lower chains and -1 for upper ones.
+ */
+inline std::vector<point_t<long long>> join_chains(std::vector<point_t<long long>> const &l,
+                                                  std::vector<point_t<long long>> const &r, int turn) {
+    std::size_t i = l.size() - 1, j = 0;
+    bool moved = true;
+    while (moved) {
+        moved = false;
+        while (i > 0 && orientation_sign(l[i - 1], l[i], r[j]) * turn <= 0) {
+            i--;
+            moved = true;
+        }
+        while (j + 1 < r.size() && orientation_sign(l[i], r[j], r[j + 1]) * turn <= 0) {
+            j++;
+            moved = true;
+        }
+    }
+    if (l[i] == r[j]) {
+        j++;
+    }
+    std::vector<point_t<long long>> result(l.begin(), l.begin() + i + 1);
+    result.insert(result.end(), r.begin() + j, r.end());
+    return result;
+}
+
+/*
+ * Same vertex order as convex_hull: counter-clockwise from the lowest, then rightmost point.
+ */
+inline std::vector<point_t<long long>> graham_order(hull_chains const &chains, std::size_t n) {
+    std::vector<point_t<long long>> result(chains.lower);
+    for (std::size_t i = chains.upper.size() - 1; i-- > 1;) {
+        result.push_back(chains.upper[i]);
+    }
+    if (result.size() == 1 && n > 1) {
+        result.push_back(result[0]);
+        return result;
+    }
+    std::rotate(result.begin(), std::min_element(result.begin(), result.end(),
+                                                 [](point_t<long long> const &p1, point_t<long long> const &p2) {
+                                                     return p1.y < p2.y || (p1.y == p2.y && p1.x > p2.x);
+                                                 }), result.end());
+    return result;
+}
+
+}
+
+/*
+ * Parallel convex hull with the same output as convex_hull.
+ * Points are sorted lexicographically with parallel_sort, sub-hulls of contiguous chunks
+ * are built concurrently with the monotone chain and joined pairwise along common tangents.
+ * Inputs smaller than sequential_cutoff go straight to convex_hull.
+ */
+inline std::vector<point_t<long long>> parallel_convex_hull(std::vector<point_t<long long>> &points,
+                                                            thread_pool &pool,
+                                                            std::size_t sequential_cutoff = 1u << 15) {
+    if (points.size() < sequential_cutoff || pool.size() == 1) {
+        return convex_hull(points);
+    }
+    parallel_sort(pool, points.begin(), points.end(), detail::lexicographic_less);
+
+    std::size_t n = points.size(), chunks = std::min<std::size_t>(4 * pool.size(), n);
+    std::vector<detail::hull_chains> hulls(chunks);
+    parallel_for(pool, chunks, [&](std::size_t i) {
+        hulls[i] = detail::monotone_chains(points.begin() + n * i / chunks, points.begin() + n * (i + 1) / chunks);
+    });
+    for (std::size_t width = 1; width < chunks; width *= 2) {
+        parallel_for(pool, (chunks + 2 * width - 1) / (2 * width), [&](std::size_t i) {
+            std::size_t from = 2 * width * i, to = from + width;
+            if (to < chunks) {
+                hulls[from].lower = detail::join_chains(hulls[from].lower, hulls[to].lower, 1);
+                hulls[from].upper = detail::join_chains(hulls[from].upper, hulls[to].upper, -1);
+            }
+        });
+    }
+    return detail::graham_order(hulls[0], n);
+}
+
+namespace detail {
+
+/*
+ * Chain vertex hit by the supporting line from p, among the vertices lexicographically after p.
+ * p must lie on the outer side of (or on) the chain; collinear ties go to the farthest vertex.
+ */
+inline std::size_t chain_tangent(std::vector<point_t<long long>> const &chain, std::size_t from,
+                                 point_t<long long> const &p, int turn) {
+    std::size_t l = from, r = chain.size() - 1;
+    while (l < r) {
+        std::size_t m = (l + r) / 2;
+        if (orientation_sign(p, chain[m], chain[m + 1]) * turn <= 0) {
+            l = m + 1;
+        } else {
+            r = m;
+        }
+    }
+    return l;
+}
+
+/*
+ * Jarvis march from the lexicographically smallest point to the largest one over precomputed
+ * group chains, one tangent query per group and step. Gives up after limit steps.
+ */
+inline bool wrap_chains(std::vector<std::vector<point_t<long long>>> const &chains,
+                        point_t<long long> const &first, point_t<long long> const &last,
+                        int turn, std::size_t limit, std::vector<point_t<long long>> &result) {
+    result.assign(1, first);
+    while (result.back() != last) {
+        if (result.size() > limit) {
+            return false;
+        }
+        point_t<long long> p = result.back(), next = last;
+        for (std::vector<point_t<long long>> const &chain : chains) {
+            std::size_t from = std::upper_bound(chain.begin(), chain.end(), p, lexicographic_less) - chain.begin();
+            if (from == chain.size()) {
+                continue;
+            }
+            point_t<long long> q = chain[chain_tangent(chain, from, p, turn)];
+            int rotate = orientation_sign(p, next, q) * turn;
+            if (rotate < 0 || (rotate == 0 && lexicographic_less(next, q))) {
+                next = q;
+            }
+        }
+        result.push_back(next);
+    }
+    return true;
+}
+
+}
+
+/*
+ * Chan's output-sensitive convex hull in O(n log h), with the same output as convex_hull.
+ * Groups of m points get their monotone chains, which are then wrapped with at most m
+ * Jarvis steps; m is squared until the hull fits. Reorders the input and drops interior points from it.
+ */
+inline std::vector<point_t<long long>> chan_convex_hull(std::vector<point_t<long long>> &points) {
+    akl_toussaint(points);
+    std::size_t n = points.size();
+    if (n == 0) {
+        return {};
+    }
+    point_t<long long> first = *std::min_element(points.begin(), points.end(), detail::lexicographic_less);
+    point_t<long long> last = *std::max_element(points.begin(), points.end(), detail::lexicographic_less);
+    for (std::size_t m = std::min<std::size_t>(4, n);; m = std::min(m * m, n)) {
+        std::vector<std::vector<point_t<long long>>> lower, upper;
+        for (std::size_t from = 0; from < n; from += m) {
+            std::size_t to = std::min(from + m, n);
+            std::sort(points.begin() + from, points.begin() + to, detail::lexicographic_less);
+            detail::hull_chains chains = detail::monotone_chains(points.begin() + from, points.begin() + to);
+            lower.push_back(std::move(chains.lower));
+            upper.push_back(std::move(chains.upper));
+        }
+        detail::hull_chains result;
+        if (detail::wrap_chains(lower, first, last, 1, m, result.lower) &&
+            detail::wrap_chains(upper, first, last, -1, m, result.upper)) {
+            return detail::graham_order(result, n);
+        }
+    }
+}
+
+/*
+ * Integer-only monotone chain hull with the same output as convex_hull.
+ * Points are radix sorted; turns use 64-bit cross products while both coordinate spans
+ * are below 2^31 and the exact 128-bit orientation otherwise. Reorders the input.
+ */
+inline std::vector<point_t<long long>> monotone_chain_hull(std::vector<point_t<long long>> &points) {
+    typedef unsigned long long ull;
+    if (points.empty()) {
+        return {};
+    }
+    radix_sort_lexicographic(points);
+    auto y_range = std::minmax_element(points.begin(), points.end(),
+                                       [](point_t<long long> const &p1, point_t<long long> const &p2) {
+                                           return p1.y < p2.y;
+                                       });
+    bool narrow = ull(points.back().x) - ull(points.front().x) < (1ull << 31) &&
+                  ull(y_range.second->y) - ull(y_range.first->y) < (1ull << 31);
+    detail::hull_chains chains = narrow ? detail::monotone_chains(points.begin(), points.end())
+                                        : detail::monotone_chains(points.begin(), points.end(),
+                                                                  detail::orientation_sign_wide);
+    return detail::graham_order(chains, points.size());
+}
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "point.h"
+#include "segment.h"
+#include "predicates.h"
+
+namespace cg {
+
+/*
+ * 0 if both segments lie on one line, 1 if s2 lies strictly on one side of s1's line,
+ * -1 if s2 touches or crosses it.
+ */
+template<typename T>
+int over_segment(segment_t<T> const &s1, segment_t<T> const &s2) {
+    int sign1 = orientation_sign(s1.p1, s1.p2, s2.p1);
+    int sign2 = orientation_sign(s1.p1, s1.p2, s2.p2);
+    if (sign1 == 0 && sign2 == 0) {
+        return 0;
+    } else {
+        return sign1 == sign2 ? 1 : -1;
+    }
+}
+
+/*
+ * Closed segments intersection test (touching counts).
+ */
+template<typename T>
+bool intersects(segment_t<T> const &s1, segment_t<T> const &s2) {
+    int over_s1 = over_segment(s1, s2);
+    int over_s2 = over_segment(s2, s1);
+    if (over_s1 == -1 && over_s2 == -1) {
+        return true;
+    } else if (over_s1 == 1 || over_s2 == 1) {
+        return false;
+    } else {
+        return s1.contains(s2.p1) || s1.contains(s2.p2) || s2.contains(s1.p1) || s2.contains(s1.p2);
+    }
+}
+
+}
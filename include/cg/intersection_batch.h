@@ -0,0 +1,242 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "intersection.h"
+#include "simd.h"
+
+/*
+ * Batched closed segment intersection tests over structure-of-arrays buffers.
+ *
+ * Every lane is first rejected by bounding boxes, then the four orientations are
+ * evaluated with the orient2d error bound. Only lanes where some orientation is
+ * uncertain (or zero, i.e. collinear configurations) go to the exact scalar intersects.
+ */
+
+namespace cg {
+
+/*
+ * Pair i tests segment (ax1[i], ay1[i]) - (ax2[i], ay2[i]) against (bx1[i], by1[i]) - (bx2[i], by2[i]).
+ */
+struct segment_pairs_view {
+    double const *ax1, *ay1, *ax2, *ay2;
+    double const *bx1, *by1, *bx2, *by2;
+    std::size_t size;
+
+    [[nodiscard]] segment_t<double> first(std::size_t i) const {
+        return {{ax1[i], ay1[i]}, {ax2[i], ay2[i]}};
+    }
+
+    [[nodiscard]] segment_t<double> second(std::size_t i) const {
+        return {{bx1[i], by1[i]}, {bx2[i], by2[i]}};
+    }
+};
+
+struct segment_pairs {
+    std::vector<double> ax1, ay1, ax2, ay2;
+    std::vector<double> bx1, by1, bx2, by2;
+
+    segment_pairs() = default;
+
+    /*
+     * Converts the flat layout of 8 doubles per pair: x1 y1 x2 y2 of the first segment, then of the second.
+     */
+    explicit segment_pairs(std::vector<double> const &data) {
+        reserve(data.size() / 8);
+        for (std::size_t i = 0; i + 8 <= data.size(); i += 8) {
+            push_back({{data[i + 0], data[i + 1]}, {data[i + 2], data[i + 3]}},
+                      {{data[i + 4], data[i + 5]}, {data[i + 6], data[i + 7]}});
+        }
+    }
+
+    void reserve(std::size_t n) {
+        for (std::vector<double> *v : {&ax1, &ay1, &ax2, &ay2, &bx1, &by1, &bx2, &by2}) {
+            v->reserve(n);
+        }
+    }
+
+    void push_back(segment_t<double> const &a, segment_t<double> const &b) {
+        ax1.push_back(a.p1.x);
+        ay1.push_back(a.p1.y);
+        ax2.push_back(a.p2.x);
+        ay2.push_back(a.p2.y);
+        bx1.push_back(b.p1.x);
+        by1.push_back(b.p1.y);
+        bx2.push_back(b.p2.x);
+        by2.push_back(b.p2.y);
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        return ax1.size();
+    }
+
+    [[nodiscard]] segment_pairs_view view() const {
+        return {ax1.data(), ay1.data(), ax2.data(), ay2.data(),
+                bx1.data(), by1.data(), bx2.data(), by2.data(), size()};
+    }
+};
+
+namespace detail {
+
+inline bool boxes_overlap(segment_pairs_view const &pairs, std::size_t i) {
+    return std::max(std::min(pairs.ax1[i], pairs.ax2[i]), std::min(pairs.bx1[i], pairs.bx2[i])) <=
+           std::min(std::max(pairs.ax1[i], pairs.ax2[i]), std::max(pairs.bx1[i], pairs.bx2[i])) &&
+           std::max(std::min(pairs.ay1[i], pairs.ay2[i]), std::min(pairs.by1[i], pairs.by2[i])) <=
+           std::min(std::max(pairs.ay1[i], pairs.ay2[i]), std::max(pairs.by1[i], pairs.by2[i]));
+}
+
+inline void intersects_scalar(segment_pairs_view const &pairs, std::size_t from, std::uint8_t *result) {
+    for (std::size_t i = from; i < pairs.size; i++) {
+        result[i] = boxes_overlap(pairs, i) && intersects(pairs.first(i), pairs.second(i));
+    }
+}
+
+#if CG_X86_SIMD
+
+struct avx2_orientation {
+    __m256d det;
+    __m256d certain;
+};
+
+CG_TARGET_AVX2 inline avx2_orientation avx2_orient(__m256d tx, __m256d ty, __m256d ax, __m256d ay,
+                                                   __m256d bx, __m256d by) {
+    __m256d const abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    __m256d left = _mm256_mul_pd(_mm256_sub_pd(ax, tx), _mm256_sub_pd(by, ty));
+    __m256d right = _mm256_mul_pd(_mm256_sub_pd(ay, ty), _mm256_sub_pd(bx, tx));
+    __m256d det = _mm256_sub_pd(left, right);
+    __m256d bound = _mm256_mul_pd(_mm256_set1_pd(ccw_bound),
+                                  _mm256_add_pd(_mm256_and_pd(left, abs_mask), _mm256_and_pd(right, abs_mask)));
+    return {det, _mm256_cmp_pd(_mm256_and_pd(det, abs_mask), bound, _CMP_GT_OQ)};
+}
+
+CG_TARGET_AVX2 inline void intersects_avx2(segment_pairs_view const &pairs, std::uint8_t *result) {
+    std::size_t i = 0;
+    __m256d const zero = _mm256_setzero_pd();
+    for (; i + 4 <= pairs.size; i += 4) {
+        __m256d ax1 = _mm256_loadu_pd(pairs.ax1 + i), ay1 = _mm256_loadu_pd(pairs.ay1 + i);
+        __m256d ax2 = _mm256_loadu_pd(pairs.ax2 + i), ay2 = _mm256_loadu_pd(pairs.ay2 + i);
+        __m256d bx1 = _mm256_loadu_pd(pairs.bx1 + i), by1 = _mm256_loadu_pd(pairs.by1 + i);
+        __m256d bx2 = _mm256_loadu_pd(pairs.bx2 + i), by2 = _mm256_loadu_pd(pairs.by2 + i);
+
+        __m256d overlap = _mm256_and_pd(
+                _mm256_cmp_pd(_mm256_max_pd(_mm256_min_pd(ax1, ax2), _mm256_min_pd(bx1, bx2)),
+                              _mm256_min_pd(_mm256_max_pd(ax1, ax2), _mm256_max_pd(bx1, bx2)), _CMP_LE_OQ),
+                _mm256_cmp_pd(_mm256_max_pd(_mm256_min_pd(ay1, ay2), _mm256_min_pd(by1, by2)),
+                              _mm256_min_pd(_mm256_max_pd(ay1, ay2), _mm256_max_pd(by1, by2)), _CMP_LE_OQ)
+        );
+        int overlap_mask = _mm256_movemask_pd(overlap);
+        if (overlap_mask == 0) {
+            std::memset(result + i, 0, 4);
+            continue;
+        }
+
+        avx2_orientation o1 = avx2_orient(ax1, ay1, ax2, ay2, bx1, by1);
+        avx2_orientation o2 = avx2_orient(ax1, ay1, ax2, ay2, bx2, by2);
+        avx2_orientation o3 = avx2_orient(bx1, by1, bx2, by2, ax1, ay1);
+        avx2_orientation o4 = avx2_orient(bx1, by1, bx2, by2, ax2, ay2);
+        __m256d certain = _mm256_and_pd(_mm256_and_pd(o1.certain, o2.certain), _mm256_and_pd(o3.certain, o4.certain));
+        __m256d crosses = _mm256_and_pd(
+                _mm256_xor_pd(_mm256_cmp_pd(o1.det, zero, _CMP_GT_OQ), _mm256_cmp_pd(o2.det, zero, _CMP_GT_OQ)),
+                _mm256_xor_pd(_mm256_cmp_pd(o3.det, zero, _CMP_GT_OQ), _mm256_cmp_pd(o4.det, zero, _CMP_GT_OQ))
+        );
+        int crosses_mask = _mm256_movemask_pd(crosses) & overlap_mask;
+        int uncertain_mask = ~_mm256_movemask_pd(certain) & overlap_mask & 0xf;
+        for (unsigned int lane = 0; lane < 4; lane++) {
+            result[i + lane] = (crosses_mask >> lane) & 1;
+        }
+        while (uncertain_mask != 0) {
+            unsigned int lane = __builtin_ctz(uncertain_mask);
+            uncertain_mask &= uncertain_mask - 1;
+            result[i + lane] = intersects(pairs.first(i + lane), pairs.second(i + lane));
+        }
+    }
+    intersects_scalar(pairs, i, result);
+}
+
+struct avx512_orientation {
+    __m512d det;
+    __mmask8 certain;
+};
+
+CG_TARGET_AVX512 inline avx512_orientation avx512_orient(__m512d tx, __m512d ty, __m512d ax, __m512d ay,
+                                                         __m512d bx, __m512d by) {
+    __m512d left = _mm512_mul_pd(_mm512_sub_pd(ax, tx), _mm512_sub_pd(by, ty));
+    __m512d right = _mm512_mul_pd(_mm512_sub_pd(ay, ty), _mm512_sub_pd(bx, tx));
+    __m512d det = _mm512_sub_pd(left, right);
+    __m512d bound = _mm512_mul_pd(_mm512_set1_pd(ccw_bound), _mm512_add_pd(_mm512_abs_pd(left), _mm512_abs_pd(right)));
+    return {det, _mm512_cmp_pd_mask(_mm512_abs_pd(det), bound, _CMP_GT_OQ)};
+}
+
+CG_TARGET_AVX512 inline void intersects_avx512(segment_pairs_view const &pairs, std::uint8_t *result) {
+    std::size_t i = 0;
+    __m512d const zero = _mm512_setzero_pd();
+    for (; i + 8 <= pairs.size; i += 8) {
+        __m512d ax1 = _mm512_loadu_pd(pairs.ax1 + i), ay1 = _mm512_loadu_pd(pairs.ay1 + i);
+        __m512d ax2 = _mm512_loadu_pd(pairs.ax2 + i), ay2 = _mm512_loadu_pd(pairs.ay2 + i);
+        __m512d bx1 = _mm512_loadu_pd(pairs.bx1 + i), by1 = _mm512_loadu_pd(pairs.by1 + i);
+        __m512d bx2 = _mm512_loadu_pd(pairs.bx2 + i), by2 = _mm512_loadu_pd(pairs.by2 + i);
+
+        __mmask8 overlap =
+                _mm512_cmp_pd_mask(_mm512_max_pd(_mm512_min_pd(ax1, ax2), _mm512_min_pd(bx1, bx2)),
+                                   _mm512_min_pd(_mm512_max_pd(ax1, ax2), _mm512_max_pd(bx1, bx2)), _CMP_LE_OQ) &
+                _mm512_cmp_pd_mask(_mm512_max_pd(_mm512_min_pd(ay1, ay2), _mm512_min_pd(by1, by2)),
+                                   _mm512_min_pd(_mm512_max_pd(ay1, ay2), _mm512_max_pd(by1, by2)), _CMP_LE_OQ);
+        if (overlap == 0) {
+            std::memset(result + i, 0, 8);
+            continue;
+        }
+
+        avx512_orientation o1 = avx512_orient(ax1, ay1, ax2, ay2, bx1, by1);
+        avx512_orientation o2 = avx512_orient(ax1, ay1, ax2, ay2, bx2, by2);
+        avx512_orientation o3 = avx512_orient(bx1, by1, bx2, by2, ax1, ay1);
+        avx512_orientation o4 = avx512_orient(bx1, by1, bx2, by2, ax2, ay2);
+        unsigned int certain = o1.certain & o2.certain & o3.certain & o4.certain;
+        unsigned int crosses =
+                (_mm512_cmp_pd_mask(o1.det, zero, _CMP_GT_OQ) ^ _mm512_cmp_pd_mask(o2.det, zero, _CMP_GT_OQ)) &
+                (_mm512_cmp_pd_mask(o3.det, zero, _CMP_GT_OQ) ^ _mm512_cmp_pd_mask(o4.det, zero, _CMP_GT_OQ)) &
+                overlap;
+        unsigned int uncertain = ~certain & overlap & 0xffu;
+        for (unsigned int lane = 0; lane < 8; lane++) {
+            result[i + lane] = (crosses >> lane) & 1;
+        }
+        while (uncertain != 0) {
+            unsigned int lane = __builtin_ctz(uncertain);
+            uncertain &= uncertain - 1;
+            result[i + lane] = intersects(pairs.first(i + lane), pairs.second(i + lane));
+        }
+    }
+    intersects_scalar(pairs, i, result);
+}
+
+#endif
+
+}
+
+/*
+ * result[i] = 1 if the closed segments of pair i intersect, 0 otherwise.
+ * Same answers as calling intersects on every pair.
+ */
+inline void intersects_batch(segment_pairs_view const &pairs, std::uint8_t *result, simd_level level) {
+    switch (level) {
+#if CG_X86_SIMD
+        case simd_level::AVX512:
+            detail::intersects_avx512(pairs, result);
+            return;
+        case simd_level::AVX2:
+            detail::intersects_avx2(pairs, result);
+            return;
+#endif
+        default:
+            detail::intersects_scalar(pairs, 0, result);
+    }
+}
+
+inline void intersects_batch(segment_pairs_view const &pairs, std::uint8_t *result) {
+    intersects_batch(pairs, result, detect_simd());
+}
+
+}
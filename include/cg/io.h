@@ -0,0 +1,57 @@
+#pragma once
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "point.h"
+
+namespace cg {
+
+template<typename T>
+std::istream &operator>>(std::istream &in, point_t<T> &p) {
+    return in >> p.x >> p.y;
+}
+
+template<typename T>
+std::ostream &operator<<(std::ostream &out, point_t<T> const &p) {
+    return out << p.x << ' ' << p.y;
+}
+
+/*
+ * Points read one by one until the end of the input. A leading line holding a single number, the
+ * count of the task inputs, is skipped, so a plain point log reads the same with or without it.
+ */
+template<typename T>
+class point_stream {
+public:
+    explicit point_stream(std::istream &in) : in_(in), pending_(false) {
+        std::string line;
+        while (std::getline(in_, line)) {
+            std::istringstream first(line);
+            T x;
+            if (!(first >> x)) {
+                continue;
+            }
+            pending_ = static_cast<bool>(first >> first_.y);
+            first_.x = x;
+            break;
+        }
+    }
+
+    bool next(point_t<T> &p) {
+        if (pending_) {
+            p = first_;
+            pending_ = false;
+            return true;
+        }
+        return static_cast<bool>(in_ >> p);
+    }
+
+private:
+    std::istream &in_;
+    point_t<T> first_;
+    bool pending_;
+};
+
+}
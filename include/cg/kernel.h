@@ -0,0 +1,6 @@
+#pragma once
+
+#include "point.h"
+#include "segment.h"
+#include "predicates.h"
+#include "io.h"
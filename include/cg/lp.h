@@ -0,0 +1,219 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "half_plane.h"
+#include "parallel.h"
+#include "point.h"
+
+namespace cg {
+
+enum class lp_status {
+    INFEASIBLE,
+    OPTIMAL,
+    UNBOUNDED
+};
+
+/*
+ * Optimal point and objective value. UNBOUNDED problems report the optimum within the bounding box.
+ */
+template<typename T>
+struct lp_result {
+    lp_status status;
+    point_t<T> point;
+    T value;
+};
+
+namespace detail {
+
+template<typename T>
+T magnitude(T const &v) {
+    return v < 0 ? -v : v;
+}
+
+/*
+ * Rounding allowance of a floating-point LP, so that feasible regions of a single point or
+ * segment are not lost to round-off; zero for exact types.
+ */
+template<typename T>
+T slack(T const &u, T const &v) {
+    return std::numeric_limits<T>::epsilon() * 64 * (magnitude(u) + magnitude(v));
+}
+
+template<typename T>
+T slack(T const &lo, T const &hi, point_t<T> const &p0, point_t<T> const &d) {
+    T scale = (magnitude(p0.x) + magnitude(p0.y)) / (magnitude(d.x) + magnitude(d.y));
+    return slack(lo, hi) + slack(scale, T(0));
+}
+
+/*
+ * Seidel's randomized incremental LP. h[0, 4) is the bounding box, h[4, m) the constraints,
+ * which are shuffled. Ties of the objective go to the perpendicular direction (-oy, ox), so the
+ * optimum is a well-defined vertex; the box keeps every 1D problem bounded. boxed tells whether
+ * one of the two sides through the optimum is a side of the box.
+ */
+template<typename T, typename Random>
+lp_result<T> seidel(semiplane_t<T> *h, std::size_t m, point_t<T> const &objective, T edge, Random &random,
+                    bool &boxed) {
+    std::shuffle(h + 4, h + m, random);
+    point_t<T> tie(-objective.y, objective.x);
+    auto preference = [&objective, &tie](point_t<T> const &d) {
+        int s = sign(objective * d);
+        return s != 0 ? s : sign(tie * d);
+    };
+    auto corner = [](T const &o, T const &t) {
+        return sign(o) != 0 ? sign(o) : sign(t) != 0 ? sign(t) : 1;
+    };
+    point_t<T> v(corner(objective.x, tie.x) > 0 ? edge : -edge, corner(objective.y, tie.y) > 0 ? edge : -edge);
+    boxed = true;
+
+    for (std::size_t i = 4; i < m; i++) {
+        if (h[i].where(v) >= 0) {
+            continue;
+        }
+        /* optimum on the boundary p0 + t * d, with n_j * d * t >= -(n_j * p0 + c_j) for j < i */
+        point_t<T> n = h[i].norm(), d = h[i].direction();
+        point_t<T> p0 = n * (-h[i].c / (n * n));
+        T lo = 0, hi = 0;
+        std::size_t lo_side = 0, hi_side = 0;
+        bool has_lo = false, has_hi = false;
+        for (std::size_t j = 0; j < i; j++) {
+            T nd = h[j].norm() * d, rhs = -(h[j].norm() * p0 + h[j].c);
+            if (nd == 0) {
+                if (rhs > 0 && rhs > slack(h[j].norm() * p0, h[j].c)) {
+                    return {lp_status::INFEASIBLE, point_t<T>(), T(0)};
+                }
+            } else if (nd > 0) {
+                T t = rhs / nd;
+                if (!has_lo || t > lo) {
+                    lo = t;
+                    lo_side = j;
+                }
+                has_lo = true;
+            } else {
+                T t = rhs / nd;
+                if (!has_hi || t < hi) {
+                    hi = t;
+                    hi_side = j;
+                }
+                has_hi = true;
+            }
+        }
+        if (lo > hi && lo - hi > slack(lo, hi, p0, d)) {
+            return {lp_status::INFEASIBLE, point_t<T>(), T(0)};
+        }
+        bool up = preference(d) > 0;
+        v = p0 + d * (up ? hi : lo);
+        boxed = (up ? hi_side : lo_side) < 4;
+    }
+    return {lp_status::OPTIMAL, v, objective * v};
+}
+
+template<typename T>
+void bounding_box(semiplane_t<T> *h, T edge) {
+    h[0] = semiplane_t<T>(1, 0, edge);
+    h[1] = semiplane_t<T>(0, 1, edge);
+    h[2] = semiplane_t<T>(-1, 0, edge);
+    h[3] = semiplane_t<T>(0, -1, edge);
+}
+
+/*
+ * Solves the problem in h[4, m) and tells bounded from unbounded: an optimum strictly inside
+ * the box is final, otherwise the problem is unbounded iff the objective still grows along the
+ * cone n_i * d >= 0, which is the same LP with every c_i = 0 and a unit box.
+ */
+template<typename T, typename Random>
+lp_result<T> solve_lp(std::vector<semiplane_t<T>> &h, std::size_t m, point_t<T> const &objective, T edge,
+                      Random &random) {
+    bool boxed;
+    bounding_box(h.data(), edge);
+    lp_result<T> result = seidel(h.data(), m, objective, edge, random, boxed);
+    if (result.status != lp_status::OPTIMAL || !boxed) {
+        return result;
+    }
+    bounding_box(h.data(), T(1));
+    for (std::size_t i = 4; i < m; i++) {
+        h[i].c = 0;
+    }
+    if (seidel(h.data(), m, objective, T(1), random, boxed).value > 0) {
+        result.status = lp_status::UNBOUNDED;
+    }
+    return result;
+}
+
+}
+
+/*
+ * Maximizes objective * p over the half-planes, expected O(n) (Seidel).
+ * The box |x|, |y| <= edge bounds the search; a problem is UNBOUNDED when the objective grows
+ * without limit, and feasibility alone is asked with a zero objective.
+ */
+template<typename T, typename Random>
+lp_result<T> solve_lp(std::vector<semiplane_t<T>> const &constraints, point_t<T> const &objective, T edge,
+                      Random &random) {
+    std::vector<semiplane_t<T>> h(4);
+    h.insert(h.end(), constraints.begin(), constraints.end());
+    return detail::solve_lp(h, h.size(), objective, edge, random);
+}
+
+template<typename T>
+lp_result<T> solve_lp(std::vector<semiplane_t<T>> const &constraints, point_t<T> const &objective, T edge) {
+    std::mt19937_64 random;
+    return solve_lp(constraints, objective, edge, random);
+}
+
+/*
+ * Problem i maximizes (ox[i], oy[i]) * p over the constraints [offset[i], offset[i + 1]) of a, b, c.
+ */
+template<typename T>
+struct lp_batch_view {
+    T const *a, *b, *c;
+    T const *ox, *oy;
+    std::size_t const *offset;
+    std::size_t size;
+};
+
+namespace detail {
+
+template<typename T>
+void solve_lp_range(lp_batch_view<T> const &problems, lp_result<T> *results, T edge,
+                    std::size_t from, std::size_t to) {
+    std::mt19937_64 random;
+    std::vector<semiplane_t<T>> h;
+    for (std::size_t i = from; i < to; i++) {
+        std::size_t first = problems.offset[i], last = problems.offset[i + 1];
+        h.resize(4 + last - first);
+        for (std::size_t k = first; k < last; k++) {
+            h[4 + k - first] = semiplane_t<T>(problems.a[k], problems.b[k], problems.c[k]);
+        }
+        results[i] = solve_lp(h, h.size(), point_t<T>(problems.ox[i], problems.oy[i]), edge, random);
+    }
+}
+
+}
+
+/*
+ * Solves every problem of the batch with one scratch buffer, so small problems do not allocate.
+ * Same answers as solve_lp on each problem, up to rounding in the order of the constraints.
+ */
+template<typename T>
+void solve_lp_batch(lp_batch_view<T> const &problems, lp_result<T> *results, T edge) {
+    detail::solve_lp_range(problems, results, edge, 0, problems.size);
+}
+
+/*
+ * The same batch split into contiguous ranges of problems on the pool.
+ */
+template<typename T>
+void solve_lp_batch(lp_batch_view<T> const &problems, lp_result<T> *results, T edge, thread_pool &pool) {
+    std::size_t chunks = std::min<std::size_t>(4 * pool.size(), problems.size);
+    parallel_for(pool, chunks, [&](std::size_t i) {
+        detail::solve_lp_range(problems, results, edge, problems.size * i / chunks, problems.size * (i + 1) / chunks);
+    });
+}
+
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace cg {
+
+/*
+ * Fixed set of worker threads taking tasks from one shared queue.
+ * Tasks must not block on futures of other tasks of the same pool.
+ */
+class thread_pool {
+public:
+    explicit thread_pool(unsigned int threads = std::thread::hardware_concurrency()) : stopping_(false) {
+        threads = std::max(threads, 1u);
+        for (unsigned int i = 0; i < threads; i++) {
+            workers_.emplace_back([this] {
+                work();
+            });
+        }
+    }
+
+    thread_pool(thread_pool const &) = delete;
+
+    thread_pool &operator=(thread_pool const &) = delete;
+
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        ready_.notify_all();
+        for (std::thread &worker : workers_) {
+            worker.join();
+        }
+    }
+
+    [[nodiscard]] unsigned int size() const {
+        return workers_.size();
+    }
+
+    template<typename F>
+    std::future<typename std::result_of<F()>::type> submit(F &&task) {
+        typedef typename std::result_of<F()>::type result_t;
+        auto packaged = std::make_shared<std::packaged_task<result_t()>>(std::forward<F>(task));
+        std::future<result_t> result = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace([packaged] {
+                (*packaged)();
+            });
+        }
+        ready_.notify_one();
+        return result;
+    }
+
+private:
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    bool stopping_;
+
+    void work() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_.wait(lock, [this] {
+                    return stopping_ || !tasks_.empty();
+                });
+                if (tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+    }
+};
+
+/*
+ * Runs body(i) for every i in [0, n) on the pool and waits for all of them.
+ */
+template<typename F>
+void parallel_for(thread_pool &pool, std::size_t n, F const &body) {
+    std::vector<std::future<void>> done;
+    done.reserve(n);
+    for (std::size_t i = 0; i < n; i++) {
+        done.push_back(pool.submit([&body, i] {
+            body(i);
+        }));
+    }
+    for (std::future<void> &f : done) {
+        f.get();
+    }
+}
+
+/*
+ * Runs body(worker, i) for every i in [0, n) and waits for all of them; worker < pool.size()
+ * identifies the task running the call, so per-worker state can be indexed without locking.
+ *
+ * Work stealing over index ranges: [0, n) starts split evenly between the workers, each taking
+ * grain indices at a time from the front of its own range. One that runs dry takes the upper
+ * half of the largest range left, so uneven items still keep every worker busy.
+ */
+template<typename F>
+void parallel_for_stealing(thread_pool &pool, std::size_t n, std::size_t grain, F const &body) {
+    struct range {
+        std::mutex lock;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+    };
+    std::size_t workers = pool.size();
+    grain = std::max<std::size_t>(grain, 1);
+    std::unique_ptr<range[]> ranges(new range[workers]);
+    for (std::size_t k = 0; k < workers; k++) {
+        ranges[k].begin = n * k / workers;
+        ranges[k].end = n * (k + 1) / workers;
+    }
+    parallel_for(pool, workers, [&](std::size_t k) {
+        range &own = ranges[k];
+        while (true) {
+            std::size_t begin, end;
+            {
+                std::lock_guard<std::mutex> lock(own.lock);
+                begin = own.begin;
+                end = std::min(own.end, begin + grain);
+                own.begin = end;
+            }
+            if (begin < end) {
+                for (std::size_t i = begin; i < end; i++) {
+                    body(k, i);
+                }
+                continue;
+            }
+            std::size_t victim = workers, largest = 0;
+            for (std::size_t j = 0; j < workers; j++) {
+                std::lock_guard<std::mutex> lock(ranges[j].lock);
+                if (ranges[j].end - ranges[j].begin > largest) {
+                    largest = ranges[j].end - ranges[j].begin;
+                    victim = j;
+                }
+            }
+            if (victim == workers) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(ranges[victim].lock);
+                begin = ranges[victim].begin + (ranges[victim].end - ranges[victim].begin) / 2;
+                end = ranges[victim].end;
+                ranges[victim].end = begin;
+            }
+            std::lock_guard<std::mutex> lock(own.lock);
+            own.begin = begin;
+            own.end = end;
+        }
+    });
+}
+
+/*
+ * Sorts equal chunks concurrently, then merges neighbouring runs pairwise, one level at a time.
+ */
+template<typename It, typename Compare>
+void parallel_sort(thread_pool &pool, It first, It last, Compare comp) {
+    std::size_t n = last - first;
+    std::size_t chunks = 1;
+    while (chunks < 2 * pool.size() && n / (2 * chunks) >= 4096) {
+        chunks *= 2;
+    }
+    if (chunks == 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+    auto bound = [first, n, chunks](std::size_t i) {
+        return first + n * i / chunks;
+    };
+    parallel_for(pool, chunks, [&](std::size_t i) {
+        std::sort(bound(i), bound(i + 1), comp);
+    });
+    for (std::size_t width = 1; width < chunks; width *= 2) {
+        parallel_for(pool, chunks / (2 * width), [&](std::size_t i) {
+            std::size_t from = 2 * width * i;
+            std::inplace_merge(bound(from), bound(from + width), bound(from + 2 * width), comp);
+        });
+    }
+}
+
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cmath>
+#include <type_traits>
+
+namespace cg {
+
+/*
+ * Point (and free vector) on the plane.
+ * Stays trivially copyable so that arrays of points can be memcpy'd and
+ * loops over them can be vectorized; every operation is constexpr and inline.
+ *
+ *   a * b -- dot product
+ *   a / b -- cross (pseudo-scalar) product
+ */
+template<typename T>
+struct point_t {
+    T x;
+    T y;
+
+    constexpr point_t() : x(0), y(0) {}
+
+    constexpr point_t(T const &x, T const &y) : x(x), y(y) {}
+
+    constexpr T operator*(point_t const &other) const {
+        return x * other.x + y * other.y;
+    }
+
+    constexpr T operator/(point_t const &other) const {
+        return x * other.y - y * other.x;
+    }
+
+    constexpr point_t operator+(point_t const &other) const {
+        return point_t(x + other.x, y + other.y);
+    }
+
+    constexpr point_t operator-(point_t const &other) const {
+        return point_t(x - other.x, y - other.y);
+    }
+
+    constexpr point_t operator-() const {
+        return point_t(-x, -y);
+    }
+
+    constexpr point_t operator*(T const &number) const {
+        return point_t(x * number, y * number);
+    }
+
+    constexpr bool operator==(point_t const &other) const {
+        return x == other.x && y == other.y;
+    }
+
+    constexpr bool operator!=(point_t const &other) const {
+        return !(*this == other);
+    }
+
+    [[nodiscard]] constexpr T sqr_length() const {
+        return x * x + y * y;
+    }
+
+    [[nodiscard]] T length() const {
+        using std::sqrt;
+        return sqrt(sqr_length());
+    }
+
+    template<typename U>
+    [[nodiscard]] constexpr point_t<U> to() const {
+        return point_t<U>((U) (x), (U) (y));
+    }
+};
+
+static_assert(std::is_trivially_copyable<point_t<long long>>::value, "point_t must stay trivially copyable");
+static_assert(std::is_trivially_copyable<point_t<double>>::value, "point_t must stay trivially copyable");
+
+template<typename T>
+constexpr T dot(point_t<T> const &a, point_t<T> const &b) {
+    return a.x * b.x + a.y * b.y;
+}
+
+template<typename T>
+constexpr T cross(point_t<T> const &a, point_t<T> const &b) {
+    return a.x * b.y - a.y * b.x;
+}
+
+template<typename T>
+constexpr int sign(T const &value) {
+    return (value == 0 ? 0 : (value > 0 ? 1 : -1));
+}
+
+/*
+ * Doubled signed area of (top, a, b): positive for a counter-clockwise turn.
+ */
+template<typename T>
+constexpr T orientation(point_t<T> const &top, point_t<T> const &a, point_t<T> const &b) {
+    return cross(a - top, b - top);
+}
+
+template<typename T>
+constexpr int orientation_sign(point_t<T> const &top, point_t<T> const &a, point_t<T> const &b) {
+    return sign(orientation(top, a, b));
+}
+
+}
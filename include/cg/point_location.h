@@ -0,0 +1,413 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "point.h"
+#include "segment.h"
+
+namespace cg {
+
+enum class position : std::uint8_t {
+    INSIDE,
+    BORDER,
+    OUTSIDE
+};
+
+namespace detail {
+
+std::size_t const locate_block = 16;
+
+}
+
+/*
+ * Point location in a convex polygon, O(log n) per query by a binary search over the fan of
+ * diagonals from the lowest leftmost vertex.
+ *
+ * The diagonals are kept as structure-of-arrays. Batches are searched in blocks of queries
+ * advancing in lockstep: a step of the search has no branches, and the loads of one step are
+ * independent across the block, so their cache misses overlap.
+ */
+class convex_locator {
+public:
+    typedef point_t<long long> point;
+
+    /*
+     * polygon is strictly convex, in either orientation, starting from any vertex.
+     */
+    explicit convex_locator(std::vector<point> polygon) {
+        if ((polygon[2] - polygon[1]) / (polygon[1] - polygon[0]) > 0) {
+            std::reverse(polygon.begin(), polygon.end());
+        }
+        std::rotate(polygon.begin(), std::min_element(polygon.begin(), polygon.end(), [](point const &p1, point const &p2) {
+            return p1.x < p2.x || (p1.x == p2.x && p1.y < p2.y);
+        }), polygon.end());
+        polygon_ = polygon;
+        for (point const &p : polygon) {
+            dx_.push_back(p.x - polygon[0].x);
+            dy_.push_back(p.y - polygon[0].y);
+        }
+    }
+
+    [[nodiscard]] position locate(point const &p) const {
+        std::size_t base = 0;
+        long long lx = p.x - polygon_[0].x, ly = p.y - polygon_[0].y;
+        for (std::size_t len = polygon_.size(); len > 1; len -= len / 2) {
+            base += behind(lx, ly, base + len / 2) ? len / 2 : 0;
+        }
+        return classify(p, base);
+    }
+
+    /*
+     * result[i] = locate(points[i]).
+     */
+    void locate(point const *points, std::size_t count, position *result) const {
+        std::size_t i = 0;
+        for (; i + detail::locate_block <= count; i += detail::locate_block) {
+            locate_block(points + i, result + i);
+        }
+        for (; i < count; i++) {
+            result[i] = locate(points[i]);
+        }
+    }
+
+private:
+    std::vector<point> polygon_;
+    std::vector<long long> dx_, dy_;
+
+    /*
+     * Whether diagonal m lies strictly clockwise of the location.
+     */
+    [[nodiscard]] bool behind(long long lx, long long ly, std::size_t m) const {
+        return lx * dy_[m] - ly * dx_[m] < 0;
+    }
+
+    /*
+     * l is the last diagonal behind p, 0 when there is none.
+     */
+    [[nodiscard]] position classify(point const &p, std::size_t l) const {
+        std::size_t n = polygon_.size();
+        if (p.x < polygon_[0].x) {
+            return position::OUTSIDE;
+        }
+        if (l > 0 && l + 2 < n) {
+            // p is not on the first or last diagonal, only the edge (l, l + 1) decides
+            return position(1 - sign((polygon_[l + 1] - polygon_[l]) / (p - polygon_[l])));
+        }
+        point location = p - polygon_[0];
+        if ((polygon_[n - 1] - polygon_[0]) / location == 0 && segment_t<long long>{polygon_[0], polygon_[n - 1]}.contains(p)) {
+            return position::BORDER;
+        }
+        if (l == n - 1) {
+            return position::OUTSIDE;
+        } else if (l == 0) {
+            if ((polygon_[1] - polygon_[0]) / location == 0 && segment_t<long long>{polygon_[0], polygon_[1]}.contains(p)) {
+                return position::BORDER;
+            }
+            return position::OUTSIDE;
+        }
+        return position(1 - sign((polygon_[l + 1] - polygon_[l]) / (p - polygon_[l])));
+    }
+
+    void locate_block(point const *points, position *result) const {
+        long long lx[detail::locate_block], ly[detail::locate_block];
+        std::size_t base[detail::locate_block];
+        for (std::size_t j = 0; j < detail::locate_block; j++) {
+            lx[j] = points[j].x - polygon_[0].x;
+            ly[j] = points[j].y - polygon_[0].y;
+            base[j] = 0;
+        }
+        for (std::size_t len = polygon_.size(); len > 1; len -= len / 2) {
+            std::size_t half = len / 2;
+            for (std::size_t j = 0; j < detail::locate_block; j++) {
+                base[j] += behind(lx[j], ly[j], base[j] + half) ? half : 0;
+            }
+        }
+        for (std::size_t j = 0; j < detail::locate_block; j++) {
+            result[j] = classify(points[j], base[j]);
+        }
+    }
+};
+
+/*
+ * Point location in a simple polygon by a persistent slab decomposition, O(n log n) to build
+ * and O(log n) per query.
+ *
+ * Distinct vertex ordinates cut the plane into horizontal slabs. The non-horizontal edges
+ * crossing a slab are kept in a treap ordered from left to right, and the treap of the next
+ * slab is derived from it by path copying, removing the edges that end on the line between them
+ * and inserting the ones that start there. Nodes are three integers in one array, the edge index
+ * packed with the parities of two subtree sizes. Answers follow the even-odd rule
+ * with half-open edges (y1, y2], like a crossing count over all edges, and BORDER for every
+ * point of an edge.
+ */
+class polygon_locator {
+public:
+    typedef point_t<long long> point;
+
+    explicit polygon_locator(std::vector<point> const &polygon) {
+        std::size_t n = polygon.size();
+        for (std::size_t i = 0; i < n; i++) {
+            point p1 = polygon[i], p2 = polygon[(i + 1) % n];
+            vertices_.push_back(key(p1));
+            ys_.push_back(p1.y);
+            if (p1.y == p2.y) {
+                horizontal_.push_back({key(p1.x < p2.x ? p1 : p2), std::max(p1.x, p2.x)});
+            } else {
+                edges_.push_back(p1.y < p2.y ? edge{p1, p2} : edge{p2, p1});
+            }
+        }
+        std::sort(vertices_.begin(), vertices_.end());
+        std::sort(horizontal_.begin(), horizontal_.end());
+        std::sort(ys_.begin(), ys_.end());
+        ys_.erase(std::unique(ys_.begin(), ys_.end()), ys_.end());
+
+        std::vector<int> starts(edges_.size()), ends(edges_.size());
+        for (std::size_t i = 0; i < edges_.size(); i++) {
+            starts[i] = ends[i] = (int) i;
+        }
+        std::sort(starts.begin(), starts.end(), [this](int i, int j) {
+            return edges_[i].lo.y < edges_[j].lo.y;
+        });
+        std::sort(ends.begin(), ends.end(), [this](int i, int j) {
+            return edges_[i].hi.y < edges_[j].hi.y;
+        });
+        int root = -1;
+        std::size_t s = 0, e = 0;
+        for (std::size_t j = 0; j + 1 < ys_.size(); j++) {
+            for (; e < ends.size() && edges_[ends[e]].hi.y == ys_[j]; e++) {
+                root = erase(root, ends[e]);
+            }
+            for (; s < starts.size() && edges_[starts[s]].lo.y == ys_[j]; s++) {
+                nodes_.push_back({-1, -1, starts[s] << 2 | 3});
+                root = insert(root, (int) nodes_.size() - 1);
+            }
+            roots_.push_back(root);
+        }
+    }
+
+    [[nodiscard]] position locate(point const &p) const {
+        position result;
+        int inside = 0;
+        for (int u = start(p, result); u != -1; u = step(p, u, inside, result)) {}
+        return result;
+    }
+
+    /*
+     * result[i] = locate(points[i]). The descents of a block of queries advance one level at
+     * a time together, so that their cache misses overlap.
+     */
+    void locate(point const *points, std::size_t count, position *result) const {
+        std::size_t i = 0;
+        for (; i + detail::locate_block <= count; i += detail::locate_block) {
+            int u[detail::locate_block], inside[detail::locate_block];
+            for (std::size_t j = 0; j < detail::locate_block; j++) {
+                u[j] = start(points[i + j], result[i + j]);
+                inside[j] = 0;
+            }
+            for (bool active = true; active;) {
+                active = false;
+                for (std::size_t j = 0; j < detail::locate_block; j++) {
+                    if (u[j] != -1) {
+                        u[j] = step(points[i + j], u[j], inside[j], result[i + j]);
+                        active |= u[j] != -1;
+                    }
+                }
+            }
+        }
+        for (; i < count; i++) {
+            result[i] = locate(points[i]);
+        }
+    }
+
+private:
+    struct edge {
+        point lo;
+        point hi;
+    };
+
+    struct node {
+        int left;
+        int right;
+        int edge;       // index << 2 | parity of the subtree size << 1 | parity of the right subtree size plus one
+    };
+
+    std::vector<edge> edges_;
+    std::vector<node> nodes_;
+    std::vector<int> roots_;                // treap of the slab (ys_[j], ys_[j + 1])
+    std::vector<long long> ys_;
+    std::vector<std::pair<long long, long long>> vertices_;       // (y, x)
+    std::vector<std::pair<std::pair<long long, long long>, long long>> horizontal_;    // ((y, x1), x2)
+
+    static std::pair<long long, long long> key(point const &p) {
+        return {p.y, p.x};
+    }
+
+    /*
+     * Number of ordinates below y, by a branch-free binary search.
+     */
+    [[nodiscard]] std::size_t slab(long long y) const {
+        std::size_t base = 0;
+        for (std::size_t len = ys_.size(); len > 1; len -= len / 2) {
+            base += ys_[base + len / 2 - 1] < y ? len / 2 : 0;
+        }
+        return base + (ys_[base] < y);
+    }
+
+    /*
+     * Root of the descent for p, or -1 with the answer in result.
+     */
+    int start(point const &p, position &result) const {
+        std::size_t k = slab(p.y);
+        result = position::OUTSIDE;
+        if (k == ys_.size()) {
+            return -1;
+        }
+        if (ys_[k] == p.y && on_line(p)) {
+            result = position::BORDER;
+            return -1;
+        }
+        // ys_[k - 1] < p.y <= ys_[k], within the y range of every edge of the slab
+        return k == 0 ? -1 : roots_[k - 1];
+    }
+
+    /*
+     * One level of the descent: the next node, or -1 with the answer in result.
+     * inside counts the parity of the edges right of p met so far.
+     */
+    int step(point const &p, int u, int &inside, position &result) const {
+        node const &v = nodes_[u];
+        edge const &f = edges_[v.edge >> 2];
+        long long rotate = (f.hi - f.lo) / (p - f.lo);
+        if (rotate == 0) {
+            result = position::BORDER;
+            return -1;
+        }
+        inside ^= rotate > 0 ? v.edge & 1 : 0;
+        int next = rotate > 0 ? v.left : v.right;
+        if (next == -1) {
+            result = inside ? position::INSIDE : position::OUTSIDE;
+        }
+        return next;
+    }
+
+    /*
+     * Whether p lies on a vertex or a horizontal edge.
+     */
+    [[nodiscard]] bool on_line(point const &p) const {
+        if (std::binary_search(vertices_.begin(), vertices_.end(), key(p))) {
+            return true;
+        }
+        auto it = std::upper_bound(horizontal_.begin(), horizontal_.end(),
+                                   std::make_pair(key(p), std::numeric_limits<long long>::max()));
+        return it != horizontal_.begin() && (--it)->first.first == p.y && p.x <= it->second;
+    }
+
+    [[nodiscard]] int parity(int u) const {
+        return u == -1 ? 0 : nodes_[u].edge >> 1 & 1;
+    }
+
+    [[nodiscard]] static unsigned long long priority(int e) {
+        unsigned long long z = (unsigned long long) e + 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    [[nodiscard]] unsigned long long priority_of(int u) const {
+        return priority(nodes_[u].edge >> 2);
+    }
+
+    [[nodiscard]] int packed(int e, int left, int right) const {
+        int flip = 1 ^ parity(right);
+        return e << 2 | (flip ^ parity(left)) << 1 | flip;
+    }
+
+    int make(int u, int left, int right) {
+        nodes_.push_back(node{left, right, packed(nodes_[u].edge >> 2, left, right)});
+        return (int) nodes_.size() - 1;
+    }
+
+    /*
+     * Whether edge a lies left of edge b, both crossing the slab above the current line, compared
+     * on b's end on the line and, if that end is shared, on its other end. Uses the lower end of
+     * an edge starting on the line and the upper end of one ending there.
+     */
+    [[nodiscard]] bool left_of(int a, int b, bool starting) const {
+        edge const &f = edges_[a], &g = edges_[b];
+        point near = starting ? g.lo : g.hi, far = starting ? g.hi : g.lo;
+        long long rotate = (f.hi - f.lo) / (near - f.lo);
+        return rotate != 0 ? rotate < 0 : (f.hi - f.lo) / (far - f.lo) < 0;
+    }
+
+    /*
+     * Treap of u without the nodes left of edge e, and of only those, copying the paths.
+     */
+    std::pair<int, int> split(int u, int e) {
+        if (u == -1) {
+            return {-1, -1};
+        }
+        node const v = nodes_[u];
+        if (left_of(v.edge >> 2, e, true)) {
+            std::pair<int, int> parts = split(v.right, e);
+            return {make(u, v.left, parts.first), parts.second};
+        }
+        std::pair<int, int> parts = split(v.left, e);
+        return {parts.first, make(u, parts.second, v.right)};
+    }
+
+    int merge(int l, int r) {
+        if (l == -1 || r == -1) {
+            return l == -1 ? r : l;
+        }
+        node const a = nodes_[l], b = nodes_[r];
+        if (priority_of(l) > priority_of(r)) {
+            return make(l, a.left, merge(a.right, r));
+        }
+        return make(r, merge(l, b.left), b.right);
+    }
+
+    /*
+     * Inserts the fresh node g of an edge starting on the current line.
+     */
+    int insert(int u, int g) {
+        if (u == -1) {
+            return g;
+        }
+        if (priority_of(g) > priority_of(u)) {
+            std::pair<int, int> parts = split(u, nodes_[g].edge >> 2);
+            nodes_[g] = {parts.first, parts.second, packed(nodes_[g].edge >> 2, parts.first, parts.second)};
+            return g;
+        }
+        node const v = nodes_[u];
+        if (left_of(v.edge >> 2, nodes_[g].edge >> 2, true)) {
+            return make(u, v.left, insert(v.right, g));
+        }
+        return make(u, insert(v.left, g), v.right);
+    }
+
+    /*
+     * Removes an edge ending on the current line; one missing from the treap (a polygon that is not
+     * simple) is ignored.
+     */
+    int erase(int u, int e) {
+        if (u == -1) {
+            return -1;
+        }
+        node const v = nodes_[u];
+        if (v.edge >> 2 == e) {
+            return merge(v.left, v.right);
+        }
+        if (left_of(v.edge >> 2, e, false)) {
+            return make(u, v.left, erase(v.right, e));
+        }
+        return make(u, erase(v.left, e), v.right);
+    }
+};
+
+}
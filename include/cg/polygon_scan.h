@@ -0,0 +1,207 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "point.h"
+#include "point_location.h"
+#include "predicates.h"
+#include "simd.h"
+
+namespace cg {
+
+enum class fill_rule {
+    EVEN_ODD,
+    NONZERO
+};
+
+namespace detail {
+
+/*
+ * Scanning works on doubles, so the vector kernels are only used when every coordinate
+ * converts exactly.
+ */
+constexpr long long scan_range = 1ll << 51;
+
+/*
+ * Contribution of edge (a, b) to the winding number of p: +1 if it goes up past p with p on its
+ * left, -1 if it goes down past p with p on its right, over half-open ranges [y1, y2) so that a
+ * vertex is counted once. Sets border if p lies on the edge.
+ */
+inline long long winding_edge(point_t<long long> const &a, point_t<long long> const &b,
+                              point_t<long long> const &p, bool &border) {
+    long long o = (b - a) / (p - a);
+    bool up = a.y <= p.y && p.y < b.y, down = b.y <= p.y && p.y < a.y;
+    border |= o == 0 && std::min(a.x, b.x) <= p.x && p.x <= std::max(a.x, b.x) &&
+              std::min(a.y, b.y) <= p.y && p.y <= std::max(a.y, b.y);
+    return (long long) (up && o > 0) - (long long) (down && o < 0);
+}
+
+/*
+ * Winding number of p over edges (v[i], v[i + 1]) for i in [from, to).
+ */
+inline long long winding_scalar(point_t<long long> const *v, std::size_t from, std::size_t to,
+                                point_t<long long> const &p, bool &border) {
+    long long winding = 0;
+    for (std::size_t i = from; i < to; i++) {
+        winding += winding_edge(v[i], v[i + 1], p, border);
+    }
+    return winding;
+}
+
+#if CG_X86_SIMD
+
+/*
+ * Orientations are evaluated in doubles with the orient2d error bound. The lanes whose sign is
+ * uncertain and whose edge can matter (it spans p vertically or its box contains p) are redone
+ * exactly; a point on an edge always has an uncertain lane, so border comes from those alone.
+ */
+CG_TARGET_AVX2 inline long long winding_avx2(point_t<long long> const *v, double const *x, double const *y,
+                                             std::size_t n, point_t<long long> const &p, bool &border) {
+    __m256d const abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    __m256d const bound = _mm256_set1_pd(ccw_bound);
+    __m256d const zero = _mm256_setzero_pd();
+    __m256d const px = _mm256_set1_pd((double) p.x), py = _mm256_set1_pd((double) p.y);
+    __m256i counts = _mm256_setzero_si256();
+    long long winding = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x1 = _mm256_loadu_pd(x + i), x2 = _mm256_loadu_pd(x + i + 1);
+        __m256d y1 = _mm256_loadu_pd(y + i), y2 = _mm256_loadu_pd(y + i + 1);
+        __m256d up = _mm256_and_pd(_mm256_cmp_pd(y1, py, _CMP_LE_OQ), _mm256_cmp_pd(py, y2, _CMP_LT_OQ));
+        __m256d down = _mm256_and_pd(_mm256_cmp_pd(y2, py, _CMP_LE_OQ), _mm256_cmp_pd(py, y1, _CMP_LT_OQ));
+        __m256d box = _mm256_and_pd(
+                _mm256_and_pd(_mm256_cmp_pd(_mm256_min_pd(x1, x2), px, _CMP_LE_OQ),
+                              _mm256_cmp_pd(px, _mm256_max_pd(x1, x2), _CMP_LE_OQ)),
+                _mm256_and_pd(_mm256_cmp_pd(_mm256_min_pd(y1, y2), py, _CMP_LE_OQ),
+                              _mm256_cmp_pd(py, _mm256_max_pd(y1, y2), _CMP_LE_OQ))
+        );
+
+        __m256d left = _mm256_mul_pd(_mm256_sub_pd(x2, x1), _mm256_sub_pd(py, y1));
+        __m256d right = _mm256_mul_pd(_mm256_sub_pd(y2, y1), _mm256_sub_pd(px, x1));
+        __m256d det = _mm256_sub_pd(left, right);
+        __m256d error = _mm256_mul_pd(bound, _mm256_add_pd(_mm256_and_pd(left, abs_mask),
+                                                           _mm256_and_pd(right, abs_mask)));
+        __m256d certain = _mm256_cmp_pd(_mm256_and_pd(det, abs_mask), error, _CMP_GT_OQ);
+
+        /* all-ones lanes are -1 as integers */
+        __m256d plus = _mm256_and_pd(_mm256_and_pd(up, certain), _mm256_cmp_pd(det, zero, _CMP_GT_OQ));
+        __m256d minus = _mm256_and_pd(_mm256_and_pd(down, certain), _mm256_cmp_pd(det, zero, _CMP_LT_OQ));
+        counts = _mm256_sub_epi64(counts, _mm256_castpd_si256(plus));
+        counts = _mm256_add_epi64(counts, _mm256_castpd_si256(minus));
+
+        unsigned int uncertain = _mm256_movemask_pd(_mm256_andnot_pd(certain, _mm256_or_pd(_mm256_or_pd(up, down), box)));
+        while (uncertain != 0) {
+            unsigned int lane = __builtin_ctz(uncertain);
+            uncertain &= uncertain - 1;
+            winding += winding_edge(v[i + lane], v[i + lane + 1], p, border);
+        }
+    }
+    alignas(32) long long lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), counts);
+    return winding + lanes[0] + lanes[1] + lanes[2] + lanes[3] + winding_scalar(v, i, n, p, border);
+}
+
+CG_TARGET_AVX512 inline long long winding_avx512(point_t<long long> const *v, double const *x, double const *y,
+                                                 std::size_t n, point_t<long long> const &p, bool &border) {
+    __m512d const bound = _mm512_set1_pd(ccw_bound);
+    __m512d const zero = _mm512_setzero_pd();
+    __m512d const px = _mm512_set1_pd((double) p.x), py = _mm512_set1_pd((double) p.y);
+    __m512i const one = _mm512_set1_epi64(1);
+    __m512i counts = _mm512_setzero_si512();
+    long long winding = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d x1 = _mm512_loadu_pd(x + i), x2 = _mm512_loadu_pd(x + i + 1);
+        __m512d y1 = _mm512_loadu_pd(y + i), y2 = _mm512_loadu_pd(y + i + 1);
+        __mmask8 up = _mm512_cmp_pd_mask(y1, py, _CMP_LE_OQ) & _mm512_cmp_pd_mask(py, y2, _CMP_LT_OQ);
+        __mmask8 down = _mm512_cmp_pd_mask(y2, py, _CMP_LE_OQ) & _mm512_cmp_pd_mask(py, y1, _CMP_LT_OQ);
+        __mmask8 box = _mm512_cmp_pd_mask(_mm512_min_pd(x1, x2), px, _CMP_LE_OQ) &
+                       _mm512_cmp_pd_mask(px, _mm512_max_pd(x1, x2), _CMP_LE_OQ) &
+                       _mm512_cmp_pd_mask(_mm512_min_pd(y1, y2), py, _CMP_LE_OQ) &
+                       _mm512_cmp_pd_mask(py, _mm512_max_pd(y1, y2), _CMP_LE_OQ);
+
+        __m512d left = _mm512_mul_pd(_mm512_sub_pd(x2, x1), _mm512_sub_pd(py, y1));
+        __m512d right = _mm512_mul_pd(_mm512_sub_pd(y2, y1), _mm512_sub_pd(px, x1));
+        __m512d det = _mm512_sub_pd(left, right);
+        __m512d error = _mm512_mul_pd(bound, _mm512_add_pd(_mm512_abs_pd(left), _mm512_abs_pd(right)));
+        __mmask8 certain = _mm512_cmp_pd_mask(_mm512_abs_pd(det), error, _CMP_GT_OQ);
+
+        counts = _mm512_mask_add_epi64(counts, up & certain & _mm512_cmp_pd_mask(det, zero, _CMP_GT_OQ), counts, one);
+        counts = _mm512_mask_sub_epi64(counts, down & certain & _mm512_cmp_pd_mask(det, zero, _CMP_LT_OQ), counts, one);
+
+        unsigned int uncertain = ~certain & (up | down | box) & 0xffu;
+        while (uncertain != 0) {
+            unsigned int lane = __builtin_ctz(uncertain);
+            uncertain &= uncertain - 1;
+            winding += winding_edge(v[i + lane], v[i + lane + 1], p, border);
+        }
+    }
+    return winding + _mm512_reduce_add_epi64(counts) + winding_scalar(v, i, n, p, border);
+}
+
+#endif
+
+}
+
+/*
+ * Point in a polygon by a linear scan over its edges, O(n) per query with no preprocessing
+ * beyond a copy, for polygons queried too few times to pay for a locator.
+ *
+ * The vertices are also kept as structure-of-arrays doubles, scanned several edges at a time
+ * without branches. The polygon may self-intersect: EVEN_ODD counts crossings, NONZERO the
+ * winding number; they agree on simple polygons. A point on an edge is BORDER under both.
+ */
+class polygon_scan {
+public:
+    typedef point_t<long long> point;
+
+    explicit polygon_scan(std::vector<point> polygon) : vertices_(std::move(polygon)), in_range_(true) {
+        vertices_.push_back(vertices_[0]);
+        for (point const &p : vertices_) {
+            in_range_ &= -detail::scan_range < p.x && p.x < detail::scan_range &&
+                         -detail::scan_range < p.y && p.y < detail::scan_range;
+            x_.push_back((double) p.x);
+            y_.push_back((double) p.y);
+        }
+    }
+
+    /*
+     * Winding number of the boundary around p, counter-clockwise positive; border is set if p
+     * lies on an edge.
+     */
+    [[nodiscard]] long long winding(point const &p, bool &border, simd_level level) const {
+        std::size_t n = vertices_.size() - 1;
+        switch (in_range_ ? level : simd_level::SCALAR) {
+#if CG_X86_SIMD
+            case simd_level::AVX512:
+                return detail::winding_avx512(vertices_.data(), x_.data(), y_.data(), n, p, border);
+            case simd_level::AVX2:
+                return detail::winding_avx2(vertices_.data(), x_.data(), y_.data(), n, p, border);
+#endif
+            default:
+                return detail::winding_scalar(vertices_.data(), 0, n, p, border);
+        }
+    }
+
+    [[nodiscard]] position locate(point const &p, fill_rule rule, simd_level level) const {
+        bool border = false;
+        long long w = winding(p, border, level);
+        bool inside = rule == fill_rule::EVEN_ODD ? (w & 1) != 0 : w != 0;
+        return border ? position::BORDER : inside ? position::INSIDE : position::OUTSIDE;
+    }
+
+    [[nodiscard]] position locate(point const &p, fill_rule rule = fill_rule::EVEN_ODD) const {
+        return locate(p, rule, detect_simd());
+    }
+
+private:
+    std::vector<point> vertices_;   // closed: vertices_.back() == vertices_[0]
+    std::vector<double> x_, y_;
+    bool in_range_;
+};
+
+}
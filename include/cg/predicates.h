@@ -0,0 +1,390 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+#include <limits>
+#include <gmpxx.h>
+
+#include "point.h"
+
+/*
+ * Adaptive exact predicates on doubles (after J. R. Shewchuk, "Adaptive Precision
+ * Floating-Point Arithmetic and Fast Robust Geometric Predicates").
+ *
+ * Every predicate runs in up to three stages:
+ *   filter    -- plain double evaluation checked against a forward error bound;
+ *   expansion -- exact evaluation with floating-point expansions on the stack;
+ *   exact     -- GMP rationals, only when the expansion stage could over- or underflow.
+ *
+ * Inputs are expected to be finite. Relies on strict IEEE double arithmetic
+ * (no x87 excess precision, no FMA contraction), see -ffp-contract=off on cg_kernel.
+ */
+
+namespace cg {
+
+struct predicate_stats {
+    unsigned long long filter;
+    unsigned long long expansion;
+    unsigned long long exact;
+};
+
+#ifndef CG_NO_PREDICATE_STATS
+#define CG_PREDICATE_COUNT(stats, stage) (++(stats).stage)
+#else
+#define CG_PREDICATE_COUNT(stats, stage) ((void) 0)
+#endif
+
+/*
+ * Per-thread stage counters, so that counting never becomes a point of contention.
+ */
+inline predicate_stats &orient2d_stats() {
+    static thread_local predicate_stats stats{0, 0, 0};
+    return stats;
+}
+
+inline predicate_stats &incircle_stats() {
+    static thread_local predicate_stats stats{0, 0, 0};
+    return stats;
+}
+
+namespace detail {
+
+constexpr double epsilon = std::numeric_limits<double>::epsilon() / 2;
+constexpr double splitter = 134217729.0;
+
+constexpr double ccw_bound = (3.0 + 16.0 * epsilon) * epsilon;
+constexpr double icc_bound = (10.0 + 96.0 * epsilon) * epsilon;
+
+// expansion products of degree d stay in the normal range while |coordinates| are in [1 / limit, limit]
+constexpr double ccw_range = 0x1p300;
+constexpr double icc_range = 0x1p150;
+
+inline void two_sum(double a, double b, double &x, double &y) {
+    x = a + b;
+    double bv = x - a;
+    double av = x - bv;
+    y = (a - av) + (b - bv);
+}
+
+inline void two_diff(double a, double b, double &x, double &y) {
+    x = a - b;
+    double bv = a - x;
+    double av = x + bv;
+    y = (a - av) + (bv - b);
+}
+
+inline void split(double a, double &hi, double &lo) {
+    double c = splitter * a;
+    double big = c - a;
+    hi = c - big;
+    lo = a - hi;
+}
+
+inline void two_product(double a, double b, double &x, double &y) {
+    x = a * b;
+    double ahi, alo, bhi, blo;
+    split(a, ahi, alo);
+    split(b, bhi, blo);
+    double err1 = x - ahi * bhi;
+    double err2 = err1 - alo * bhi;
+    double err3 = err2 - ahi * blo;
+    y = alo * blo - err3;
+}
+
+/*
+ * Nonoverlapping sequence of doubles ordered by increasing magnitude, zero components eliminated.
+ * The value is the exact sum of the components; its sign is the sign of the last one.
+ */
+template<std::size_t N>
+struct expansion {
+    std::size_t n;
+    double e[N];
+
+    [[nodiscard]] int sign() const {
+        return n == 0 ? 0 : cg::sign(e[n - 1]);
+    }
+};
+
+inline expansion<2> difference(double a, double b) {
+    expansion<2> result{0, {}};
+    double x, y;
+    two_diff(a, b, x, y);
+    if (y != 0) {
+        result.e[result.n++] = y;
+    }
+    if (x != 0) {
+        result.e[result.n++] = x;
+    }
+    return result;
+}
+
+/*
+ * Shewchuk's fast_expansion_sum_zeroelim: h = e + f, returns the length of h.
+ */
+inline std::size_t sum(std::size_t elen, double const *e, std::size_t flen, double const *f, double *h) {
+    if (elen == 0 || flen == 0) {
+        double const *src = elen == 0 ? f : e;
+        std::size_t len = elen == 0 ? flen : elen;
+        for (std::size_t i = 0; i < len; i++) {
+            h[i] = src[i];
+        }
+        return len;
+    }
+    double q, qnew, hh;
+    std::size_t ei = 0, fi = 0, hi = 0;
+    double enow = e[0], fnow = f[0];
+    if ((fnow > enow) == (fnow > -enow)) {
+        q = enow;
+        enow = ++ei < elen ? e[ei] : 0;
+    } else {
+        q = fnow;
+        fnow = ++fi < flen ? f[fi] : 0;
+    }
+    if (ei < elen && fi < flen) {
+        if ((fnow > enow) == (fnow > -enow)) {
+            qnew = enow + q;
+            hh = q - (qnew - enow);
+            enow = ++ei < elen ? e[ei] : 0;
+        } else {
+            qnew = fnow + q;
+            hh = q - (qnew - fnow);
+            fnow = ++fi < flen ? f[fi] : 0;
+        }
+        q = qnew;
+        if (hh != 0) {
+            h[hi++] = hh;
+        }
+        while (ei < elen && fi < flen) {
+            if ((fnow > enow) == (fnow > -enow)) {
+                two_sum(q, enow, qnew, hh);
+                enow = ++ei < elen ? e[ei] : 0;
+            } else {
+                two_sum(q, fnow, qnew, hh);
+                fnow = ++fi < flen ? f[fi] : 0;
+            }
+            q = qnew;
+            if (hh != 0) {
+                h[hi++] = hh;
+            }
+        }
+    }
+    while (ei < elen) {
+        two_sum(q, enow, qnew, hh);
+        enow = ++ei < elen ? e[ei] : 0;
+        q = qnew;
+        if (hh != 0) {
+            h[hi++] = hh;
+        }
+    }
+    while (fi < flen) {
+        two_sum(q, fnow, qnew, hh);
+        fnow = ++fi < flen ? f[fi] : 0;
+        q = qnew;
+        if (hh != 0) {
+            h[hi++] = hh;
+        }
+    }
+    if (q != 0) {
+        h[hi++] = q;
+    }
+    return hi;
+}
+
+/*
+ * Shewchuk's scale_expansion_zeroelim: h = e * b, returns the length of h.
+ */
+inline std::size_t scale(std::size_t elen, double const *e, double b, double *h) {
+    if (elen == 0) {
+        return 0;
+    }
+    double q, sum, hh, product1, product0;
+    std::size_t hi = 0;
+    two_product(e[0], b, q, hh);
+    if (hh != 0) {
+        h[hi++] = hh;
+    }
+    for (std::size_t i = 1; i < elen; i++) {
+        two_product(e[i], b, product1, product0);
+        two_sum(q, product0, sum, hh);
+        if (hh != 0) {
+            h[hi++] = hh;
+        }
+        two_sum(product1, sum, q, hh);
+        if (hh != 0) {
+            h[hi++] = hh;
+        }
+    }
+    if (q != 0) {
+        h[hi++] = q;
+    }
+    return hi;
+}
+
+template<std::size_t A, std::size_t B>
+expansion<A + B> operator+(expansion<A> const &a, expansion<B> const &b) {
+    expansion<A + B> result;
+    result.n = sum(a.n, a.e, b.n, b.e, result.e);
+    return result;
+}
+
+template<std::size_t A, std::size_t B>
+expansion<A + B> operator-(expansion<A> const &a, expansion<B> const &b) {
+    expansion<B> negated = b;
+    for (std::size_t i = 0; i < negated.n; i++) {
+        negated.e[i] = -negated.e[i];
+    }
+    return a + negated;
+}
+
+template<std::size_t A, std::size_t B>
+expansion<2 * A * B> operator*(expansion<A> const &a, expansion<B> const &b) {
+    expansion<2 * A * B> result[2];
+    unsigned int cur = 0;
+    result[cur].n = 0;
+    double part[2 * A];
+    for (std::size_t i = 0; i < b.n; i++) {
+        std::size_t len = scale(a.n, a.e, b.e[i], part);
+        result[cur ^ 1].n = sum(result[cur].n, result[cur].e, len, part, result[cur ^ 1].e);
+        cur ^= 1;
+    }
+    return result[cur];
+}
+
+inline bool in_range(double value, double limit) {
+    value = std::abs(value);
+    return value == 0 || (1 / limit <= value && value <= limit);
+}
+
+template<typename... Ts>
+bool all_in_range(double limit, Ts... values) {
+    bool result = true;
+    for (double value : {values...}) {
+        result &= in_range(value, limit);
+    }
+    return result;
+}
+
+inline int cross_gmp(point_t<double> const &a1, point_t<double> const &b1,
+                     point_t<double> const &a2, point_t<double> const &b2) {
+    return sign((b1.to<mpq_class>() - a1.to<mpq_class>()) / (b2.to<mpq_class>() - a2.to<mpq_class>()));
+}
+
+inline int orient2d_gmp(point_t<double> const &a, point_t<double> const &b, point_t<double> const &c) {
+    return cross_gmp(c, a, c, b);
+}
+
+inline int incircle_gmp(point_t<double> const &a, point_t<double> const &b,
+                        point_t<double> const &c, point_t<double> const &d) {
+    point_t<mpq_class> qd = d.to<mpq_class>();
+    point_t<mpq_class> da = a.to<mpq_class>() - qd, db = b.to<mpq_class>() - qd, dc = c.to<mpq_class>() - qd;
+    mpq_class det = da.sqr_length() * (db / dc) + db.sqr_length() * (dc / da) + dc.sqr_length() * (da / db);
+    return sign(det);
+}
+
+}
+
+/*
+ * Sign of the cross product (b1 - a1) / (b2 - a2), i.e. of the turn from the first vector to the second.
+ */
+inline int cross_sign(point_t<double> const &a1, point_t<double> const &b1,
+                      point_t<double> const &a2, point_t<double> const &b2) {
+    using namespace detail;
+    predicate_stats &stats = orient2d_stats();
+
+    double left = (b1.x - a1.x) * (b2.y - a2.y);
+    double right = (b1.y - a1.y) * (b2.x - a2.x);
+    double det = left - right;
+    double det_sum;
+    if (left > 0) {
+        if (right <= 0) {
+            CG_PREDICATE_COUNT(stats, filter);
+            return sign(det);
+        }
+        det_sum = left + right;
+    } else if (left < 0) {
+        if (right >= 0) {
+            CG_PREDICATE_COUNT(stats, filter);
+            return sign(det);
+        }
+        det_sum = -left - right;
+    } else {
+        CG_PREDICATE_COUNT(stats, filter);
+        return sign(det);
+    }
+    double bound = ccw_bound * det_sum;
+    if (det >= bound || -det >= bound) {
+        CG_PREDICATE_COUNT(stats, filter);
+        return sign(det);
+    }
+
+    if (!all_in_range(ccw_range, a1.x, a1.y, b1.x, b1.y, a2.x, a2.y, b2.x, b2.y)) {
+        CG_PREDICATE_COUNT(stats, exact);
+        return cross_gmp(a1, b1, a2, b2);
+    }
+    CG_PREDICATE_COUNT(stats, expansion);
+    auto dx1 = difference(b1.x, a1.x), dy1 = difference(b1.y, a1.y);
+    auto dx2 = difference(b2.x, a2.x), dy2 = difference(b2.y, a2.y);
+    return (dx1 * dy2 - dy1 * dx2).sign();
+}
+
+/*
+ * Sign of the turn a -> b -> c: +1 for counter-clockwise, -1 for clockwise, 0 for collinear.
+ * Same as orientation_sign(a, b, c).
+ */
+inline int orient2d(point_t<double> const &a, point_t<double> const &b, point_t<double> const &c) {
+    return cross_sign(c, a, c, b);
+}
+
+/*
+ * Positive if d lies inside the circle through a, b, c (given counter-clockwise),
+ * negative if outside, zero if the four points are cocircular.
+ */
+inline int incircle(point_t<double> const &a, point_t<double> const &b,
+                    point_t<double> const &c, point_t<double> const &d) {
+    using namespace detail;
+    predicate_stats &stats = incircle_stats();
+
+    double adx = a.x - d.x, ady = a.y - d.y;
+    double bdx = b.x - d.x, bdy = b.y - d.y;
+    double cdx = c.x - d.x, cdy = c.y - d.y;
+
+    double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+    double cdxady = cdx * ady, adxcdy = adx * cdy;
+    double adxbdy = adx * bdy, bdxady = bdx * ady;
+    double alift = adx * adx + ady * ady;
+    double blift = bdx * bdx + bdy * bdy;
+    double clift = cdx * cdx + cdy * cdy;
+
+    double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+    double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * alift +
+                       (std::abs(cdxady) + std::abs(adxcdy)) * blift +
+                       (std::abs(adxbdy) + std::abs(bdxady)) * clift;
+    double bound = icc_bound * permanent;
+    if (det > bound || -det > bound) {
+        CG_PREDICATE_COUNT(stats, filter);
+        return sign(det);
+    }
+
+    if (!all_in_range(icc_range, a.x, a.y, b.x, b.y, c.x, c.y, d.x, d.y)) {
+        CG_PREDICATE_COUNT(stats, exact);
+        return incircle_gmp(a, b, c, d);
+    }
+    CG_PREDICATE_COUNT(stats, expansion);
+    auto eadx = difference(a.x, d.x), eady = difference(a.y, d.y);
+    auto ebdx = difference(b.x, d.x), ebdy = difference(b.y, d.y);
+    auto ecdx = difference(c.x, d.x), ecdy = difference(c.y, d.y);
+    auto ea = (eadx * eadx + eady * eady) * (ebdx * ecdy - ecdx * ebdy);
+    auto eb = (ebdx * ebdx + ebdy * ebdy) * (ecdx * eady - eadx * ecdy);
+    auto ec = (ecdx * ecdx + ecdy * ecdy) * (eadx * ebdy - ebdx * eady);
+    return (ea + eb + ec).sign();
+}
+
+/*
+ * Robust replacement of the generic orientation_sign for double coordinates.
+ */
+inline int orientation_sign(point_t<double> const &top, point_t<double> const &a, point_t<double> const &b) {
+    return orient2d(top, a, b);
+}
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "point.h"
+
+namespace cg {
+
+/*
+ * LSD radix sort of integer points in lexicographic order (by x, then by y).
+ * Keys are the coordinates shifted to start at zero, taken 16 bits at a time; passes where
+ * every key has the same digit are skipped, so coordinates within 32 bits take four passes.
+ * Inputs too small to pay for the histograms fall back to std::sort.
+ */
+inline void radix_sort_lexicographic(std::vector<point_t<long long>> &points) {
+    typedef unsigned long long ull;
+    typedef point_t<long long> point;
+
+    std::size_t const n = points.size();
+    if (n < (1u << 16)) {
+        std::sort(points.begin(), points.end(), [](point const &p1, point const &p2) {
+            return p1.x < p2.x || (p1.x == p2.x && p1.y < p2.y);
+        });
+        return;
+    }
+
+    unsigned int const bits = 16, digits = 4, buckets = 1u << bits;
+    point min = points[0];
+    for (point const &p : points) {
+        min.x = std::min(min.x, p.x);
+        min.y = std::min(min.y, p.y);
+    }
+    auto key = [&min](point const &p, unsigned int pass) -> ull {
+        return pass < digits ? ull(p.y) - ull(min.y) : ull(p.x) - ull(min.x);
+    };
+
+    std::vector<std::size_t> count(2 * digits * buckets);
+    for (point const &p : points) {
+        ull ky = key(p, 0), kx = key(p, digits);
+        for (unsigned int d = 0; d < digits; d++) {
+            count[d * buckets + ((ky >> (d * bits)) & (buckets - 1))]++;
+            count[(digits + d) * buckets + ((kx >> (d * bits)) & (buckets - 1))]++;
+        }
+    }
+
+    std::vector<point> buffer(n);
+    point *from = points.data(), *to = buffer.data();
+    for (unsigned int pass = 0; pass < 2 * digits; pass++) {
+        std::size_t *offset = count.data() + pass * buckets;
+        unsigned int shift = pass % digits * bits;
+        if (offset[(key(from[0], pass) >> shift) & (buckets - 1)] == n) {
+            continue;
+        }
+        std::size_t sum = 0;
+        for (unsigned int d = 0; d < buckets; d++) {
+            std::size_t c = offset[d];
+            offset[d] = sum;
+            sum += c;
+        }
+        for (std::size_t i = 0; i < n; i++) {
+            to[offset[(key(from[i], pass) >> shift) & (buckets - 1)]++] = from[i];
+        }
+        std::swap(from, to);
+    }
+    if (from != points.data()) {
+        points.swap(buffer);
+    }
+}
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <algorithm>
+
+#include "point.h"
+
+namespace cg {
+
+template<typename T>
+struct segment_t {
+    point_t<T> p1;
+    point_t<T> p2;
+
+    [[nodiscard]] constexpr point_t<T> vectorize() const {
+        return p2 - p1;
+    }
+
+    /*
+     * Bounding box test only: combined with a zero orientation it tells
+     * whether a collinear point lies on the segment.
+     */
+    [[nodiscard]] constexpr bool contains(point_t<T> const &p) const {
+        return std::min(p1.x, p2.x) <= p.x && p.x <= std::max(p1.x, p2.x) &&
+               std::min(p1.y, p2.y) <= p.y && p.y <= std::max(p1.y, p2.y);
+    }
+};
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+/*
+ * Runtime instruction set dispatch.
+ * Kernels are compiled for several targets with function attributes, so the whole
+ * library still builds without -march flags, and the best one is picked on the first call.
+ */
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CG_X86_SIMD 1
+#include <immintrin.h>
+#define CG_TARGET_AVX2 __attribute__((target("avx2")))
+#define CG_TARGET_AVX512 __attribute__((target("avx512f,avx512dq")))
+#else
+#define CG_X86_SIMD 0
+#endif
+
+namespace cg {
+
+enum class simd_level {
+    SCALAR,
+    AVX2,
+    AVX512
+};
+
+inline simd_level detect_simd() {
+#if CG_X86_SIMD
+    static simd_level const level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+            return simd_level::AVX512;
+        } else if (__builtin_cpu_supports("avx2")) {
+            return simd_level::AVX2;
+        } else {
+            return simd_level::SCALAR;
+        }
+    }();
+    return level;
+#else
+    return simd_level::SCALAR;
+#endif
+}
+
+}
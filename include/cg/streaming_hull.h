@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "hull.h"
+#include "point.h"
+
+namespace cg {
+
+/*
+ * Convex hull of a point stream in O(h + chunk) memory.
+ * Points are buffered, and a full buffer is merged with the current hull vertices by convex_hull,
+ * so at any moment hull() is exactly convex_hull of everything pushed so far.
+ */
+class streaming_hull {
+public:
+    typedef point_t<long long> point;
+
+    explicit streaming_hull(std::size_t chunk = 1u << 20) : chunk_(std::max<std::size_t>(chunk, 1)), points_(0) {
+        buffer_.reserve(chunk_);
+    }
+
+    void push(point const &p) {
+        buffer_.push_back(p);
+        points_++;
+        if (buffer_.size() >= chunk_) {
+            merge();
+        }
+    }
+
+    /*
+     * Current hull, in the same format as convex_hull.
+     */
+    std::vector<point> const &hull() {
+        if (!buffer_.empty()) {
+            merge();
+        }
+        return hull_;
+    }
+
+    /*
+     * Points pushed so far.
+     */
+    [[nodiscard]] std::size_t points() const {
+        return points_;
+    }
+
+private:
+    std::size_t chunk_;
+    std::size_t points_;
+    std::vector<point> hull_;
+    std::vector<point> buffer_;
+
+    void merge() {
+        buffer_.insert(buffer_.end(), hull_.begin(), hull_.end());
+        hull_ = convex_hull(buffer_);
+        buffer_.clear();
+    }
+};
+
+}
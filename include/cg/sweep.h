@@ -0,0 +1,422 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <gmpxx.h>
+
+#include "point.h"
+#include "segment.h"
+#include "predicates.h"
+
+namespace cg {
+
+/*
+ * Bentley-Ottmann sweep: reports every intersecting pair among n closed segments
+ * in O((n + k) log n), where k is the number of reported pairs.
+ *
+ * The sweep line moves in lexicographic (x, then y) order. Events are segment endpoints
+ * and crossings of neighbouring segments. A crossing is kept as a rounded point with an
+ * absolute error bound and evaluated with GMP only when the bound cannot decide a comparison.
+ *
+ * The status is an array-based treap indexed by segment id, split and merged around every
+ * event point (segments below / through / above it), so its order is never compared by
+ * approximate y values: only the exact orientation of an event point against a segment.
+ * Left endpoints are sorted once up front; right endpoints (pushed on insertion) and crossings
+ * live in a pooled vector, and the queue is a binary heap of indices into it, so the heap
+ * only ever holds events of segments currently crossing the sweep line.
+ *
+ * Every intersecting pair is reported exactly once, collinear overlapping pairs
+ * at the leftmost common point.
+ */
+class intersection_sweep {
+public:
+    explicit intersection_sweep(std::vector<segment_t<double>> const &segments) :
+            segments_(segments),
+            left_(segments.size(), -1),
+            right_(segments.size(), -1),
+            priority_(segments.size()),
+            root_(-1) {
+        std::uint32_t seed = 2463534242u;
+        for (unsigned int i = 0; i < segments_.size(); i++) {
+            segment_t<double> &s = segments_[i];
+            if (s.p2.x < s.p1.x || (s.p2.x == s.p1.x && s.p2.y < s.p1.y)) {
+                std::swap(s.p1, s.p2);
+            }
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            priority_[i] = seed;
+        }
+    }
+
+    /*
+     * Calls report(i, j) with i < j for every pair of intersecting segments (indices into the input).
+     */
+    template<typename Callback>
+    void run(Callback &&report) {
+        events_.clear();
+        heap_.clear();
+        free_events_.clear();
+        exact_.clear();
+        free_exact_.clear();
+        root_ = -1;
+
+        std::vector<unsigned int> lefts(segments_.size());
+        for (unsigned int i = 0; i < lefts.size(); i++) {
+            lefts[i] = i;
+        }
+        std::sort(lefts.begin(), lefts.end(), [this](unsigned int i, unsigned int j) {
+            point_t<double> const &p = segments_[i].p1, &q = segments_[j].p1;
+            return p.x < q.x || (p.x == q.x && p.y < q.y);
+        });
+
+        unsigned int next_left = 0;
+        std::vector<unsigned int> starting;
+        while (next_left < lefts.size() || !heap_.empty()) {
+            event current;
+            if (next_left < lefts.size()) {
+                current = endpoint(segments_[lefts[next_left]].p1, event_kind::LEFT, lefts[next_left]);
+            }
+            if (!heap_.empty() && (next_left == lefts.size() || compare(events_[heap_.front()], current) < 0)) {
+                unsigned int top = pop();
+                current = events_[top];
+                free_events_.push_back(top);
+            }
+
+            starting.clear();
+            while (next_left < lefts.size() && same(segments_[lefts[next_left]].p1, current)) {
+                starting.push_back(lefts[next_left++]);
+            }
+            while (!heap_.empty() && compare(events_[heap_.front()], current) == 0) {
+                release(pop());
+            }
+            process(current, starting, report);
+            release_exact(current);
+        }
+    }
+
+private:
+    enum class event_kind : std::uint8_t {
+        LEFT,
+        RIGHT,
+        CROSS
+    };
+
+    struct event {
+        point_t<double> at;
+        double ex;
+        double ey;
+        int exact;
+        unsigned int a;
+        unsigned int b;
+        event_kind kind;
+    };
+
+    struct later {
+        intersection_sweep *sweep;
+
+        bool operator()(unsigned int e, unsigned int f) const {
+            return sweep->compare(sweep->events_[e], sweep->events_[f]) > 0;
+        }
+    };
+
+    std::vector<segment_t<double>> segments_;
+    std::vector<int> left_;
+    std::vector<int> right_;
+    std::vector<std::uint32_t> priority_;
+    int root_;
+
+    std::vector<event> events_;
+    std::vector<unsigned int> free_events_;
+    std::vector<unsigned int> heap_;
+    std::vector<point_t<mpq_class>> exact_;
+    std::vector<unsigned int> free_exact_;
+
+    std::vector<unsigned int> meeting_;
+    std::vector<unsigned int> continuing_;
+
+    later order() {
+        return {this};
+    }
+
+    static event endpoint(point_t<double> const &p, event_kind kind, unsigned int segment) {
+        return {p, 0, 0, -1, segment, segment, kind};
+    }
+
+    unsigned int pop() {
+        std::pop_heap(heap_.begin(), heap_.end(), order());
+        unsigned int top = heap_.back();
+        heap_.pop_back();
+        return top;
+    }
+
+    void push(event const &e) {
+        unsigned int index;
+        if (free_events_.empty()) {
+            index = events_.size();
+            events_.push_back(e);
+        } else {
+            index = free_events_.back();
+            free_events_.pop_back();
+            events_[index] = e;
+        }
+        heap_.push_back(index);
+        std::push_heap(heap_.begin(), heap_.end(), order());
+    }
+
+    void release_exact(event &e) {
+        if (e.exact >= 0) {
+            free_exact_.push_back(e.exact);
+            e.exact = -1;
+        }
+    }
+
+    void release(unsigned int index) {
+        release_exact(events_[index]);
+        free_events_.push_back(index);
+    }
+
+    /*
+     * Crossing point a + (b - a) * t of two properly crossing segments, with absolute error bounds.
+     */
+    event crossing(unsigned int i, unsigned int j) const {
+        using detail::epsilon;
+        point_t<double> const &a = segments_[i].p1, &b = segments_[i].p2;
+        point_t<double> const &c = segments_[j].p1, &d = segments_[j].p2;
+        double nl = (c.x - a.x) * (d.y - c.y), nr = (c.y - a.y) * (d.x - c.x);
+        double dl = (b.x - a.x) * (d.y - c.y), dr = (b.y - a.y) * (d.x - c.x);
+        double num = nl - nr, den = dl - dr;
+        double en = detail::ccw_bound * (std::abs(nl) + std::abs(nr));
+        double ed = detail::ccw_bound * (std::abs(dl) + std::abs(dr));
+
+        event e{a, std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(), -1,
+                i, j, event_kind::CROSS};
+        if (!(std::abs(den) > 2 * ed) || !std::isfinite(num)) {
+            return e;
+        }
+        double t = num / den;
+        double et = (std::abs(num) * ed + std::abs(den) * en) / (std::abs(den) * (std::abs(den) - ed)) +
+                    epsilon * std::abs(t);
+        double dx = b.x - a.x, dy = b.y - a.y;
+        e.at = point_t<double>(a.x + t * dx, a.y + t * dy);
+        // doubled to cover the rounding of the bound itself
+        e.ex = 2 * (et * std::abs(dx) + 2 * epsilon * (std::abs(t * dx) + std::abs(e.at.x)));
+        e.ey = 2 * (et * std::abs(dy) + 2 * epsilon * (std::abs(t * dy) + std::abs(e.at.y)));
+        return e;
+    }
+
+    point_t<mpq_class> exact_point(event &e) {
+        if (e.kind != event_kind::CROSS) {
+            return e.at.to<mpq_class>();
+        }
+        if (e.exact < 0) {
+            segment_t<double> const &s1 = segments_[e.a], &s2 = segments_[e.b];
+            point_t<mpq_class> a = s1.p1.to<mpq_class>(), b = s1.p2.to<mpq_class>();
+            point_t<mpq_class> c = s2.p1.to<mpq_class>(), d = s2.p2.to<mpq_class>();
+            mpq_class t = ((c - a) / (d - c)) / ((b - a) / (d - c));
+            point_t<mpq_class> p = a + (b - a) * t;
+            if (free_exact_.empty()) {
+                e.exact = exact_.size();
+                exact_.push_back(p);
+            } else {
+                e.exact = free_exact_.back();
+                free_exact_.pop_back();
+                exact_[e.exact] = p;
+            }
+        }
+        return exact_[e.exact];
+    }
+
+    /*
+     * Lexicographic comparison of event points.
+     */
+    int compare(event &e, event &f) {
+        if (e.kind != event_kind::CROSS && f.kind != event_kind::CROSS) {
+            if (e.at.x != f.at.x) {
+                return e.at.x < f.at.x ? -1 : 1;
+            }
+            return e.at.y == f.at.y ? 0 : (e.at.y < f.at.y ? -1 : 1);
+        }
+        if (e.at.x + e.ex < f.at.x - f.ex) {
+            return -1;
+        }
+        if (e.at.x - e.ex > f.at.x + f.ex) {
+            return 1;
+        }
+        point_t<mpq_class> p = exact_point(e), q = exact_point(f);
+        int by_x = cmp(p.x, q.x);
+        return by_x != 0 ? sign(by_x) : sign(cmp(p.y, q.y));
+    }
+
+    bool same(point_t<double> const &p, event &e) {
+        event q = endpoint(p, event_kind::LEFT, 0);
+        return compare(q, e) == 0;
+    }
+
+    /*
+     * Orientation of the event point against the line of segment s: positive if it lies above.
+     */
+    int side(unsigned int s, event &p) {
+        segment_t<double> const &segment = segments_[s];
+        if (p.kind != event_kind::CROSS) {
+            return orient2d(segment.p1, segment.p2, p.at);
+        }
+        double dx = segment.p2.x - segment.p1.x, dy = segment.p2.y - segment.p1.y;
+        double l = dx * (p.at.y - segment.p1.y), r = dy * (p.at.x - segment.p1.x);
+        double det = l - r;
+        double error = 2 * (4 * detail::epsilon * (std::abs(l) + std::abs(r)) + std::abs(dx) * p.ey +
+                            std::abs(dy) * p.ex);
+        if (std::abs(det) > error) {
+            return sign(det);
+        }
+        point_t<mpq_class> q = exact_point(p), p1 = segment.p1.to<mpq_class>();
+        return sign((segment.p2.to<mpq_class>() - p1) / (q - p1));
+    }
+
+    bool properly_cross(unsigned int i, unsigned int j) const {
+        segment_t<double> const &s1 = segments_[i], &s2 = segments_[j];
+        int o1 = orient2d(s1.p1, s1.p2, s2.p1), o2 = orient2d(s1.p1, s1.p2, s2.p2);
+        if (o1 == 0 || o2 == 0 || o1 == o2) {
+            return false;
+        }
+        int o3 = orient2d(s2.p1, s2.p2, s1.p1), o4 = orient2d(s2.p1, s2.p2, s1.p2);
+        return o3 != 0 && o4 != 0 && o3 != o4;
+    }
+
+    bool collinear_overlap(unsigned int i, unsigned int j) const {
+        segment_t<double> const &s1 = segments_[i], &s2 = segments_[j];
+        return s1.p1 != s1.p2 && s2.p1 != s2.p2 &&
+               orient2d(s1.p1, s1.p2, s2.p1) == 0 && orient2d(s1.p1, s1.p2, s2.p2) == 0;
+    }
+
+    template<typename Predicate>
+    void split(int t, Predicate const &before, int &l, int &r) {
+        if (t < 0) {
+            l = r = -1;
+        } else if (before(t)) {
+            split(right_[t], before, right_[t], r);
+            l = t;
+        } else {
+            split(left_[t], before, l, left_[t]);
+            r = t;
+        }
+    }
+
+    int merge(int l, int r) {
+        if (l < 0 || r < 0) {
+            return l < 0 ? r : l;
+        }
+        if (priority_[l] > priority_[r]) {
+            right_[l] = merge(right_[l], r);
+            return l;
+        } else {
+            left_[r] = merge(l, left_[r]);
+            return r;
+        }
+    }
+
+    void collect(int t, std::vector<unsigned int> &out) const {
+        if (t >= 0) {
+            collect(left_[t], out);
+            out.push_back(t);
+            collect(right_[t], out);
+        }
+    }
+
+    int lowest(int t) const {
+        while (t >= 0 && left_[t] >= 0) {
+            t = left_[t];
+        }
+        return t;
+    }
+
+    int highest(int t) const {
+        while (t >= 0 && right_[t] >= 0) {
+            t = right_[t];
+        }
+        return t;
+    }
+
+    void schedule(int below, int above, event &current) {
+        if (below < 0 || above < 0 || !properly_cross(below, above)) {
+            return;
+        }
+        event e = crossing(below, above);
+        if (compare(e, current) > 0) {
+            push(e);
+        } else {
+            release_exact(e);
+        }
+    }
+
+    template<typename Callback>
+    void process(event &current, std::vector<unsigned int> const &starting, Callback &report) {
+        int below, rest, through, above;
+        split(root_, [this, &current](int s) { return side(s, current) > 0; }, below, rest);
+        split(rest, [this, &current](int s) { return side(s, current) == 0; }, through, above);
+
+        meeting_.clear();
+        collect(through, meeting_);
+        meeting_.insert(meeting_.end(), starting.begin(), starting.end());
+        for (unsigned int x = 0; x < meeting_.size(); x++) {
+            for (unsigned int y = x + 1; y < meeting_.size(); y++) {
+                unsigned int i = std::min(meeting_[x], meeting_[y]), j = std::max(meeting_[x], meeting_[y]);
+                if (collinear_overlap(i, j)) {
+                    point_t<double> const &p1 = segments_[i].p1, &p2 = segments_[j].p1;
+                    bool first = p1.x < p2.x || (p1.x == p2.x && p1.y < p2.y);
+                    if (!same(first ? p2 : p1, current)) {
+                        continue;
+                    }
+                }
+                report(i, j);
+            }
+        }
+
+        continuing_.clear();
+        for (unsigned int s : meeting_) {
+            if (!same(segments_[s].p2, current)) {
+                continuing_.push_back(s);
+            }
+        }
+        for (unsigned int s : starting) {
+            if (segments_[s].p1 != segments_[s].p2) {
+                push(endpoint(segments_[s].p2, event_kind::RIGHT, s));
+            }
+        }
+        std::sort(continuing_.begin(), continuing_.end(), [this](unsigned int s, unsigned int t) {
+            return cross_sign(segments_[s].p1, segments_[s].p2, segments_[t].p1, segments_[t].p2) > 0;
+        });
+        int middle = -1;
+        for (unsigned int s : continuing_) {
+            left_[s] = right_[s] = -1;
+            middle = merge(middle, s);
+        }
+
+        int lower = highest(below), upper = lowest(above);
+        if (continuing_.empty()) {
+            schedule(lower, upper, current);
+        } else {
+            schedule(lower, continuing_.front(), current);
+            schedule(continuing_.back(), upper, current);
+        }
+        root_ = merge(merge(below, middle), above);
+    }
+};
+
+template<typename Callback>
+void report_intersections(std::vector<segment_t<double>> const &segments, Callback &&report) {
+    intersection_sweep(segments).run(report);
+}
+
+inline unsigned long long count_intersections(std::vector<segment_t<double>> const &segments) {
+    unsigned long long count = 0;
+    report_intersections(segments, [&count](unsigned int, unsigned int) {
+        count++;
+    });
+    return count;
+}
+
+}
@@ -0,0 +1,647 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "parallel.h"
+#include "point.h"
+
+namespace cg {
+
+/*
+ * Vertex indices into the polygon, counter-clockwise.
+ */
+typedef std::array<std::uint32_t, 3> triangle;
+
+/*
+ * Cyclic doubly linked list over 0 .. n - 1, the links of all vertices in one arena of 32-bit
+ * indices. Removing a vertex relinks its neighbours and keeps its own links, so a walk may still
+ * step off it; assign reuses the storage, so one ring can serve polygon after polygon.
+ */
+class polygon_ring {
+public:
+    void assign(std::size_t n) {
+        links_.resize(n);
+        for (std::uint32_t i = 0; i < n; i++) {
+            links_[i] = {(std::uint32_t) (i == 0 ? n - 1 : i - 1), (std::uint32_t) (i + 1 == n ? 0 : i + 1)};
+        }
+    }
+
+    [[nodiscard]] std::uint32_t prev(std::uint32_t i) const {
+        return links_[i].prev;
+    }
+
+    [[nodiscard]] std::uint32_t next(std::uint32_t i) const {
+        return links_[i].next;
+    }
+
+    void unlink(std::uint32_t i) {
+        links_[links_[i].prev].next = links_[i].next;
+        links_[links_[i].next].prev = links_[i].prev;
+    }
+
+private:
+    struct link {
+        std::uint32_t prev;
+        std::uint32_t next;
+    };
+
+    std::vector<link> links_;
+};
+
+namespace detail {
+
+/*
+ * Sweep from top to bottom: a above b if a.y > b.y, or a.y == b.y and a.x < b.x. This is the
+ * order of a plane rotated by an infinitesimal angle, so no two vertices are at the same height
+ * and every orientation keeps its sign.
+ */
+inline bool above(point_t<long long> const &a, point_t<long long> const &b) {
+    return a.y > b.y || (a.y == b.y && a.x < b.x);
+}
+
+/*
+ * v = polygon in counter-clockwise order, v[i] = polygon[id[i]].
+ */
+inline void counter_clockwise(point_t<long long> const *polygon, std::size_t n,
+                              std::vector<point_t<long long>> &v, std::vector<std::uint32_t> &id) {
+    __int128 area = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        point_t<long long> const &a = polygon[i], &b = polygon[i + 1 == n ? 0 : i + 1];
+        area += (__int128) a.x * b.y - (__int128) a.y * b.x;
+    }
+    v.assign(polygon, polygon + n);
+    id.resize(n);
+    for (std::uint32_t i = 0; i < n; i++) {
+        id[i] = i;
+    }
+    if (area < 0) {
+        std::reverse(v.begin(), v.end());
+        std::reverse(id.begin(), id.end());
+    }
+}
+
+enum class vertex_kind : std::uint8_t {
+    START,
+    SPLIT,
+    END,
+    MERGE,
+    REGULAR
+};
+
+/*
+ * Diagonals splitting a counter-clockwise simple polygon into y-monotone pieces
+ * (de Berg et al., "Computational Geometry", ch. 3). order lists the vertices from top to bottom.
+ *
+ * The status holds the edges (i, i + 1) with the interior on their right, that is the ones
+ * going down. Two edges in it are compared by the orientation of the lower of their upper
+ * endpoints against the other edge; both cross the sweep line and do not cross each other, so
+ * this is their left to right order without computing any intersection.
+ */
+inline std::vector<std::pair<std::uint32_t, std::uint32_t>> monotone_diagonals(
+        std::vector<point_t<long long>> const &v, std::vector<std::uint32_t> const &order) {
+    typedef point_t<long long> point;
+    std::size_t n = v.size();
+    auto next = [n](std::uint32_t i) {
+        return (std::uint32_t) (i + 1 == n ? 0 : i + 1);
+    };
+    auto prev = [n](std::uint32_t i) {
+        return (std::uint32_t) (i == 0 ? n - 1 : i - 1);
+    };
+
+    std::vector<vertex_kind> kind(n);
+    for (std::uint32_t i = 0; i < n; i++) {
+        point const &a = v[prev(i)], &b = v[i], &c = v[next(i)];
+        bool convex = orientation(a, b, c) > 0;
+        if (above(b, a) && above(b, c)) {
+            kind[i] = convex ? vertex_kind::START : vertex_kind::SPLIT;
+        } else if (above(a, b) && above(c, b)) {
+            kind[i] = convex ? vertex_kind::END : vertex_kind::MERGE;
+        } else {
+            kind[i] = vertex_kind::REGULAR;
+        }
+    }
+
+    /* edge i goes from v[i] (upper) to v[i + 1] (lower) */
+    struct edge_less {
+        typedef void is_transparent;
+
+        std::vector<point> const &v;
+        std::size_t n;
+
+        [[nodiscard]] point const &lower(std::uint32_t e) const {
+            return v[e + 1 == n ? 0 : e + 1];
+        }
+
+        /* p strictly left of edge e */
+        [[nodiscard]] bool left(point const &p, std::uint32_t e) const {
+            return cross(lower(e) - v[e], p - v[e]) < 0;
+        }
+
+        bool operator()(std::uint32_t a, std::uint32_t b) const {
+            if (a == b) {
+                return false;
+            }
+            return above(v[b], v[a]) ? left(v[a], b) : !left(v[b], a);
+        }
+
+        bool operator()(std::uint32_t e, point const &p) const {
+            return cross(lower(e) - v[e], p - v[e]) > 0;
+        }
+
+        bool operator()(point const &p, std::uint32_t e) const {
+            return left(p, e);
+        }
+    };
+    std::set<std::uint32_t, edge_less> status(edge_less{v, n});
+    std::vector<std::uint32_t> helper(n);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> diagonals;
+
+    /* the status edge directly left of v[i] */
+    auto left_of = [&](std::uint32_t i) {
+        return *std::prev(status.lower_bound(v[i]));
+    };
+    auto close = [&](std::uint32_t e, std::uint32_t i) {
+        if (kind[helper[e]] == vertex_kind::MERGE) {
+            diagonals.emplace_back(i, helper[e]);
+        }
+    };
+
+    for (std::uint32_t i : order) {
+        std::uint32_t e;
+        switch (kind[i]) {
+            case vertex_kind::START:
+                status.insert(i);
+                helper[i] = i;
+                break;
+            case vertex_kind::END:
+                close(prev(i), i);
+                status.erase(prev(i));
+                break;
+            case vertex_kind::SPLIT:
+                e = left_of(i);
+                diagonals.emplace_back(i, helper[e]);
+                helper[e] = i;
+                status.insert(i);
+                helper[i] = i;
+                break;
+            case vertex_kind::MERGE:
+                close(prev(i), i);
+                status.erase(prev(i));
+                e = left_of(i);
+                close(e, i);
+                helper[e] = i;
+                break;
+            case vertex_kind::REGULAR:
+                if (above(v[prev(i)], v[i])) {
+                    close(prev(i), i);
+                    status.erase(prev(i));
+                    status.insert(i);
+                    helper[i] = i;
+                } else {
+                    e = left_of(i);
+                    close(e, i);
+                    helper[e] = i;
+                }
+                break;
+        }
+    }
+    return diagonals;
+}
+
+/*
+ * Triangulates a y-monotone piece given counter-clockwise, rank[i] being the position of vertex i
+ * in the sweep order, by the stack walk down both chains at once.
+ */
+inline void triangulate_monotone_piece(std::vector<point_t<long long>> const &v,
+                                       std::vector<std::uint32_t> const &rank,
+                                       std::vector<std::uint32_t> &piece,
+                                       std::vector<triangle> &result) {
+    typedef point_t<long long> point;
+    std::size_t k = piece.size();
+    auto emit = [&](std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+        if (orientation(v[a], v[b], v[c]) < 0) {
+            std::swap(b, c);
+        }
+        result.push_back({a, b, c});
+    };
+    if (k == 3) {
+        emit(piece[0], piece[1], piece[2]);
+        return;
+    }
+
+    /* going counter-clockwise from the top, the left chain descends */
+    std::size_t top = 0;
+    for (std::size_t j = 1; j < k; j++) {
+        top = rank[piece[j]] < rank[piece[top]] ? j : top;
+    }
+    std::rotate(piece.begin(), piece.begin() + top, piece.end());
+    std::size_t bottom = 0;
+    for (std::size_t j = 1; j < k; j++) {
+        bottom = rank[piece[j]] > rank[piece[bottom]] ? j : bottom;
+    }
+    std::vector<std::pair<std::uint32_t, bool>> sorted{{piece[0], true}};     // (vertex, on the left chain)
+    sorted.reserve(k);
+    std::size_t l = 1, r = k - 1;
+    while (l <= bottom || r > bottom) {
+        if (r == bottom || (l <= bottom && rank[piece[l]] < rank[piece[r]])) {
+            sorted.emplace_back(piece[l++], true);
+        } else {
+            sorted.emplace_back(piece[r--], false);
+        }
+    }
+
+    /* point b between a and c on a chain is convex towards the interior */
+    auto convex = [&](std::uint32_t a, std::uint32_t b, std::uint32_t c, bool left_chain) {
+        point const &pa = v[a], &pb = v[b], &pc = v[c];
+        return left_chain ? orientation(pa, pb, pc) > 0 : orientation(pc, pb, pa) > 0;
+    };
+    std::vector<std::pair<std::uint32_t, bool>> stack{sorted[0], sorted[1]};
+    for (std::size_t j = 2; j + 1 < k; j++) {
+        std::pair<std::uint32_t, bool> u = sorted[j];
+        if (u.second != stack.back().second) {
+            for (std::size_t s = 0; s + 1 < stack.size(); s++) {
+                emit(u.first, stack[s].first, stack[s + 1].first);
+            }
+            std::pair<std::uint32_t, bool> last = stack.back();
+            stack.assign({last, u});
+        } else {
+            std::pair<std::uint32_t, bool> last = stack.back();
+            stack.pop_back();
+            while (!stack.empty() && convex(stack.back().first, last.first, u.first, u.second)) {
+                emit(u.first, last.first, stack.back().first);
+                last = stack.back();
+                stack.pop_back();
+            }
+            stack.push_back(last);
+            stack.push_back(u);
+        }
+    }
+    std::uint32_t lowest = sorted[k - 1].first;
+    for (std::size_t s = 0; s + 1 < stack.size(); s++) {
+        emit(lowest, stack[s].first, stack[s + 1].first);
+    }
+}
+
+/*
+ * Uniform grid over the vertices that may block an ear: the ones not strictly convex. Clipping
+ * only makes the angles of the remaining vertices smaller, so this set only shrinks and the
+ * grid is built once per polygon, its entries dropped lazily by the caller's flags. The storage
+ * is kept from one polygon to the next.
+ *
+ * With few such vertices the grid is a single cell, scanned without locating the triangle; for
+ * small polygons that is cheaper than walking its rows.
+ */
+class blocker_grid {
+public:
+    typedef point_t<long long> point;
+
+    void build(std::vector<point> const &v, std::vector<char> const &blocking) {
+        std::size_t m = 0;
+        lo_ = hi_ = v[0];
+        for (std::size_t i = 0; i < v.size(); i++) {
+            m += blocking[i];
+            lo_ = point(std::min(lo_.x, v[i].x), std::min(lo_.y, v[i].y));
+            hi_ = point(std::max(hi_.x, v[i].x), std::max(hi_.y, v[i].y));
+        }
+        long double w = (long double) hi_.x - lo_.x + 1, h = (long double) hi_.y - lo_.y + 1;
+        long double cells = (long double) std::max<std::size_t>(m, 1);
+        side_ = m <= linear_limit ? (long long) std::ceil(std::max(w, h))
+                                  : std::max(1LL, (long long) std::ceil(std::max(std::sqrt(w * h / cells), std::max(w, h) / cells)));
+        columns_ = (std::size_t) ((hi_.x - lo_.x) / side_ + 1);
+        start_.assign(columns_ * ((std::size_t) ((hi_.y - lo_.y) / side_ + 1)) + 1, 0);
+        for (std::size_t i = 0; i < v.size(); i++) {
+            start_[cell(v[i]) + 1] += blocking[i];
+        }
+        for (std::size_t c = 0; c + 1 < start_.size(); c++) {
+            start_[c + 1] += start_[c];
+        }
+        fill_.assign(start_.begin(), start_.end() - 1);
+        vertices_.resize(m);
+        for (std::size_t i = 0; i < v.size(); i++) {
+            if (blocking[i]) {
+                vertices_[fill_[cell(v[i])]++] = (std::uint32_t) i;
+            }
+        }
+    }
+
+    /*
+     * Whether pred(i) holds for a listed vertex in a cell meeting triangle abc. Row by row, the
+     * cells are the ones between the extreme abscissae of the edges within the row, widened by a
+     * unit against rounding.
+     */
+    template<typename F>
+    bool any(point const &a, point const &b, point const &c, F const &pred) const {
+        if (start_.size() == 2) {
+            return std::any_of(vertices_.begin(), vertices_.end(), pred);
+        }
+        point const *corners[3] = {&a, &b, &c};
+        long long top = std::max({a.y, b.y, c.y}), bottom = std::min({a.y, b.y, c.y});
+        for (std::size_t y = row(bottom); y <= row(top); y++) {
+            long long low = std::max(bottom, lo_.y + (long long) y * side_);
+            long long high = std::min(top, lo_.y + (long long) (y + 1) * side_);
+            long double left = (long double) hi_.x, right = (long double) lo_.x;
+            for (unsigned int k = 0; k < 3; k++) {
+                point const &p = *corners[k], &q = *corners[(k + 1) % 3];
+                long long y1 = std::max(low, std::min(p.y, q.y)), y2 = std::min(high, std::max(p.y, q.y));
+                if (y1 > y2) {
+                    continue;
+                }
+                for (long long t : {y1, y2}) {
+                    long double x = p.y == q.y ? (long double) std::min(p.x, q.x)
+                                               : p.x + (long double) (q.x - p.x) * (t - p.y) / (q.y - p.y);
+                    long double x2 = p.y == q.y ? (long double) std::max(p.x, q.x) : x;
+                    left = std::min(left, x);
+                    right = std::max(right, x2);
+                }
+            }
+            std::size_t x0 = column(std::max(lo_.x, (long long) std::floor(left) - 1));
+            std::size_t x1 = column(std::min(hi_.x, (long long) std::ceil(right) + 1));
+            for (std::size_t k = start_[y * columns_ + x0]; k < start_[y * columns_ + x1 + 1]; k++) {
+                if (pred(vertices_[k])) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    static constexpr std::size_t linear_limit = 32;
+
+    point lo_, hi_;
+    long long side_;
+    std::size_t columns_;
+    std::vector<std::uint32_t> start_;      // vertices_[start_[c], start_[c + 1]) in cell c, row by row
+    std::vector<std::uint32_t> fill_;
+    std::vector<std::uint32_t> vertices_;
+
+    [[nodiscard]] std::size_t column(long long x) const {
+        return (std::size_t) ((x - lo_.x) / side_);
+    }
+
+    [[nodiscard]] std::size_t row(long long y) const {
+        return (std::size_t) ((y - lo_.y) / side_);
+    }
+
+    [[nodiscard]] std::size_t cell(point const &p) const {
+        return row(p.y) * columns_ + column(p.x);
+    }
+};
+
+}
+
+/*
+ * Triangulation of a simple polygon in O(n log n): a sweep cuts it into y-monotone pieces,
+ * each triangulated in linear time. Gives n - 2 triangles; collinear vertices can force
+ * degenerate ones. The polygon may be in either orientation. Triangles are appended to result.
+ */
+inline void triangulate_monotone(std::vector<point_t<long long>> const &polygon, std::vector<triangle> &result) {
+    typedef point_t<long long> point;
+    std::size_t n = polygon.size();
+    if (n < 3) {
+        return;
+    }
+    std::vector<point> v;
+    std::vector<std::uint32_t> id;
+    detail::counter_clockwise(polygon.data(), n, v, id);
+
+    std::vector<std::uint32_t> order(n), rank(n);
+    for (std::uint32_t i = 0; i < n; i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&v](std::uint32_t a, std::uint32_t b) {
+        return detail::above(v[a], v[b]);
+    });
+    for (std::uint32_t i = 0; i < n; i++) {
+        rank[order[i]] = i;
+    }
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> diagonals = detail::monotone_diagonals(v, order);
+
+    /*
+     * Half-edges: every vertex lists its neighbours counter-clockwise around it. The face left of
+     * u -> w continues along w -> x with x the neighbour before u around w.
+     */
+    std::vector<std::uint32_t> start(n + 1, 0);
+    for (std::uint32_t i = 0; i < n; i++) {
+        start[i + 1] += 2;
+    }
+    for (auto const &d : diagonals) {
+        start[d.first + 1]++;
+        start[d.second + 1]++;
+    }
+    for (std::uint32_t i = 0; i < n; i++) {
+        start[i + 1] += start[i];
+    }
+    std::vector<std::uint32_t> to(start[n]), fill(start.begin(), start.end() - 1);
+    for (std::uint32_t i = 0; i < n; i++) {
+        to[fill[i]++] = (std::uint32_t) ((i + 1) % n);
+        to[fill[i]++] = (std::uint32_t) ((i + n - 1) % n);
+    }
+    for (auto const &d : diagonals) {
+        to[fill[d.first]++] = d.second;
+        to[fill[d.second]++] = d.first;
+    }
+    for (std::uint32_t i = 0; i < n; i++) {
+        point const &c = v[i];
+        std::sort(to.begin() + start[i], to.begin() + start[i + 1], [&v, &c](std::uint32_t a, std::uint32_t b) {
+            point da = v[a] - c, db = v[b] - c;
+            bool ha = da.y < 0 || (da.y == 0 && da.x < 0), hb = db.y < 0 || (db.y == 0 && db.x < 0);
+            return ha != hb ? hb : cross(da, db) > 0;
+        });
+    }
+    auto find = [&](std::uint32_t from, std::uint32_t target) {
+        std::uint32_t k = start[from];
+        while (to[k] != target) {
+            k++;
+        }
+        return k;
+    };
+
+    /* the outer face runs along i + 1 -> i */
+    std::vector<char> used(to.size(), 0);
+    for (std::uint32_t i = 0; i < n; i++) {
+        used[find((std::uint32_t) ((i + 1) % n), i)] = 1;
+    }
+    std::size_t first = result.size();
+    result.reserve(first + n - 2);
+    std::vector<std::uint32_t> piece;
+    for (std::uint32_t i = 0; i < n; i++) {
+        for (std::uint32_t k = start[i]; k < start[i + 1]; k++) {
+            if (used[k]) {
+                continue;
+            }
+            piece.clear();
+            std::uint32_t u = i, e = k;
+            while (!used[e]) {
+                used[e] = 1;
+                piece.push_back(u);
+                std::uint32_t w = to[e];
+                std::uint32_t back = find(w, u);
+                e = back == start[w] ? start[w + 1] - 1 : back - 1;
+                u = w;
+            }
+            detail::triangulate_monotone_piece(v, rank, piece, result);
+        }
+    }
+    for (std::size_t k = first; k < result.size(); k++) {
+        triangle &t = result[k];
+        t = {id[t[0]], id[t[1]], id[t[2]]};
+    }
+}
+
+inline std::vector<triangle> triangulate_monotone(std::vector<point_t<long long>> const &polygon) {
+    std::vector<triangle> result;
+    triangulate_monotone(polygon, result);
+    return result;
+}
+
+/*
+ * Ear clipping (after the earcut library): only a vertex that is not strictly convex can lie in
+ * an ear, so candidates are tested against those, looked up in a grid. Ears wait in a queue; a
+ * clip changes nothing but the two neighbours, and only they are tested again. Near O(n log n)
+ * on typical polygons, O(n^2) in the worst case (long runs of collinear vertices force long
+ * triangles across many cells).
+ *
+ * A point on the border of a candidate blocks it, as in the plain clipper. If no ear is left on
+ * invalid input, a vertex is clipped anyway, so there are always n - 2 triangles.
+ *
+ * The working buffers are members and keep their storage, so a clipper reused for many polygons
+ * stops allocating once it has seen the largest one.
+ */
+class ear_clipper {
+public:
+    typedef point_t<long long> point;
+
+    /*
+     * Writes the max(n - 2, 0) triangles of polygon[0, n) to result.
+     */
+    void triangulate(point const *polygon, std::size_t n, triangle *result) {
+        if (n < 3) {
+            return;
+        }
+        if (n == 3) {
+            result[0] = {0, 1, 2};
+            if (orientation(polygon[0], polygon[1], polygon[2]) < 0) {
+                std::swap(result[0][1], result[0][2]);
+            }
+            return;
+        }
+        detail::counter_clockwise(polygon, n, v_, id_);
+        ring_.assign(n);
+        blocking_.resize(n);
+        ear_.assign(n, 0);
+        removed_.assign(n, 0);
+        for (std::uint32_t i = 0; i < n; i++) {
+            blocking_[i] = orientation(v_[ring_.prev(i)], v_[i], v_[ring_.next(i)]) <= 0;
+        }
+        grid_.build(v_, blocking_);
+
+        ears_.clear();
+        for (std::uint32_t i = 0; i < n; i++) {
+            if (is_ear(i)) {
+                ear_[i] = 1;
+                ears_.push_back(i);
+            }
+        }
+        std::uint32_t any = 0;
+        std::size_t head = 0;
+        for (std::size_t remaining = n; remaining > 3; remaining--) {
+            std::uint32_t b = any;
+            while (head < ears_.size()) {
+                std::uint32_t candidate = ears_[head++];
+                if (!removed_[candidate] && ear_[candidate]) {
+                    b = candidate;
+                    break;
+                }
+            }
+            std::uint32_t a = ring_.prev(b), c = ring_.next(b);
+            *result++ = {id_[a], id_[b], id_[c]};
+            ring_.unlink(b);
+            removed_[b] = 1;
+            blocking_[b] = 0;
+            any = a;
+            for (std::uint32_t u : {a, c}) {
+                blocking_[u] &= orientation(v_[ring_.prev(u)], v_[u], v_[ring_.next(u)]) <= 0;
+                bool now = is_ear(u);
+                if (now && !ear_[u]) {
+                    ears_.push_back(u);
+                }
+                ear_[u] = now;
+            }
+        }
+        *result = {id_[ring_.prev(any)], id_[any], id_[ring_.next(any)]};
+    }
+
+private:
+    std::vector<point> v_;
+    std::vector<std::uint32_t> id_;
+    polygon_ring ring_;
+    std::vector<char> blocking_, ear_, removed_;
+    std::vector<std::uint32_t> ears_;
+    detail::blocker_grid grid_;
+
+    [[nodiscard]] bool is_ear(std::uint32_t b) const {
+        std::uint32_t a = ring_.prev(b), c = ring_.next(b);
+        point const &pa = v_[a], &pb = v_[b], &pc = v_[c];
+        if (orientation(pa, pb, pc) <= 0) {
+            return false;
+        }
+        return !grid_.any(pa, pb, pc, [&](std::uint32_t p) {
+            return blocking_[p] && p != a && p != c && orientation(pa, pb, v_[p]) >= 0 &&
+                   orientation(pb, pc, v_[p]) >= 0 && orientation(pc, pa, v_[p]) >= 0;
+        });
+    }
+};
+
+/*
+ * Appends the triangles of polygon to result, see ear_clipper.
+ */
+inline void triangulate_ears(std::vector<point_t<long long>> const &polygon, std::vector<triangle> &result) {
+    std::size_t first = result.size();
+    result.resize(first + std::max<std::size_t>(polygon.size(), 2) - 2);
+    ear_clipper().triangulate(polygon.data(), polygon.size(), result.data() + first);
+}
+
+inline std::vector<triangle> triangulate_ears(std::vector<point_t<long long>> const &polygon) {
+    std::vector<triangle> result;
+    triangulate_ears(polygon, result);
+    return result;
+}
+
+/*
+ * Triangles of many polygons, those of polygon i in triangles[offset[i], offset[i + 1]).
+ */
+struct triangulation_batch {
+    std::vector<std::size_t> offset;
+    std::vector<triangle> triangles;
+};
+
+/*
+ * Ear clips polygons i in [0, count), polygon i being points[start[i], start[i + 1]), on the
+ * pool. A polygon of n vertices has max(n - 2, 0) triangles, so every output range is known up
+ * front and workers write straight into the shared buffer; each keeps its own ear_clipper as an
+ * arena, and polygons are handed out by work stealing since their sizes can differ widely.
+ */
+inline triangulation_batch triangulate_batch(point_t<long long> const *points, std::size_t const *start,
+                                             std::size_t count, thread_pool &pool) {
+    triangulation_batch result;
+    result.offset.resize(count + 1, 0);
+    for (std::size_t i = 0; i < count; i++) {
+        std::size_t n = start[i + 1] - start[i];
+        result.offset[i + 1] = result.offset[i] + std::max<std::size_t>(n, 2) - 2;
+    }
+    result.triangles.resize(result.offset[count]);
+    std::vector<ear_clipper> arenas(pool.size());
+    parallel_for_stealing(pool, count, 64, [&](std::size_t worker, std::size_t i) {
+        arenas[worker].triangulate(points + start[i], start[i + 1] - start[i], result.triangles.data() + result.offset[i]);
+    });
+    return result;
+}
+
+}
@@ -3,82 +3,27 @@
 #include <vector>
 #include <algorithm>
 
-using namespace std;
-
-template<typename T>
-struct point_t {
-    T x;
-    T y;
-
-    point_t() : x(0), y(0) {}
-
-    point_t(T const &x, T const &y) : x(x), y(y) {}
-
-    point_t(point_t<T> const &other) = default;
+#include <cg/kernel.h>
+#include <cg/binary_io.h>
+#include <cg/hull.h>
+#include <cg/dynamic_hull.h>
+#include <cg/streaming_hull.h>
 
-    T operator*(point_t const &other) const {
-        return x * other.x + y * other.y;
-    }
-
-    T operator/(point_t const &other) const {
-        return x * other.y - y * other.x;
-    }
-
-    point_t operator-(point_t const &other) const {
-        return point_t(x - other.x, y - other.y);
-    }
-
-    [[nodiscard]] T sqr_length() const {
-        return x * x + y * y;
-    }
-
-    template<typename U>
-    [[nodiscard]] point_t<U> to() const {
-        return point_t<U>{(U) (x), (U) y};
-    }
-};
-
-template<typename T>
-istream &operator>>(istream &in, point_t<T> &p) {
-    return in >> p.x >> p.y;
-}
-
-template<typename T>
-ostream &operator<<(ostream &out, point_t<T> const &p) {
-    return out << p.x << ' ' << p.y;
-}
+using namespace std;
+using namespace cg;
 
 typedef long long ll;
 typedef unsigned long long ull;
 typedef point_t<ll> point;
 
-vector<point> convex_hull(vector<point> &points) {
-    point p = *min_element(points.begin(), points.end(), [](point const &p1, point const &p2) {
-        return p1.y < p2.y || (p1.y == p2.y && p1.x > p2.x);
-    });
-    sort(points.begin(), points.end(), [&p](point const &p1, point const &p2) {
-        ll rotate = (p1 - p) / (p2 - p);
-        return rotate > 0 || (rotate == 0 && (p1 - p).to<ull>().sqr_length() < (p2 - p).to<ull>().sqr_length());
-    });
-    vector<point> result{p};
-    for (unsigned int i = 1; i < points.size(); i++) {
-        point next = points[i];
-        while (result.size() >= 2) {
-            point v_prev = result.back() - result[result.size() - 2];
-            point v_next = next - result.back();
-            ll rotate = v_next / v_prev;
-            if (rotate >= 0) {
-                result.pop_back();
-            } else {
-                break;
-            }
-        }
-        result.push_back(next);
+void print_hull(vector<point> const &res) {
+    cout << res.size() << '\n';
+    for (point const &p: res) {
+        cout << p << '\n';
     }
-    return result;
 }
 
-int main() {
+int main(int argc, char **argv) {
 
     ios_base::sync_with_stdio(false);
     cin.tie(nullptr);
@@ -88,18 +33,70 @@ int main() {
     freopen("hull.out", "w", stdout);
 #endif
 
-    unsigned int n;
-    cin >> n;
+    tool_options options(argc, argv, {{"--stream", "", "uu"}, {"--parallel"}, {"--output-sensitive"}, {"--monotone"}, {"--dynamic"}});
+    if (!options) {
+        cerr << options.error() << '\n';
+        return 1;
+    }
+    mapped_file binary = options.binary();
+    array_view<point> input;
+    if (binary) {
+        input = binary.view<point>(0);
+    }
+
+    if (options.is("--stream")) {
+        size_t chunk = options.unsigned_argument(0, 1u << 20);
+        unsigned long long checkpoint = options.unsigned_argument(1, 0);
+        streaming_hull hull(chunk);
+        unsigned long long i = 0;
+        auto push = [&](point const &p) {
+            hull.push(p);
+            if (checkpoint != 0 && ++i % checkpoint == 0) {
+                cerr << i << " points: " << hull.hull().size() << " hull vertices\n";
+            }
+        };
+        if (binary) {
+            for (point const &p : input) {
+                push(p);
+            }
+        } else {
+            point_stream<ll> in(cin);
+            point p;
+            while (in.next(p)) {
+                push(p);
+            }
+        }
+        print_hull(hull.hull());
+        return 0;
+    }
 
-    vector<point> points(n);
-    for (point &p : points) {
-        cin >> p;
+    vector<point> points(input.begin(), input.end());
+    if (!binary) {
+        unsigned int n;
+        cin >> n;
+        points.resize(n);
+        for (point &p : points) {
+            cin >> p;
+        }
     }
 
-    auto res = convex_hull(points);
-    cout << res.size() << '\n';
-    for (point const &p: res) {
-        cout << p << '\n';
+    vector<point> res;
+    if (options.is("--parallel")) {
+        thread_pool pool;
+        res = parallel_convex_hull(points, pool);
+    } else if (options.is("--output-sensitive")) {
+        res = chan_convex_hull(points);
+    } else if (options.is("--monotone")) {
+        res = monotone_chain_hull(points);
+    } else if (options.is("--dynamic")) {
+        dynamic_hull hull;
+        for (point const &p : points) {
+            hull.insert(p);
+        }
+        res = hull.hull();
+    } else {
+        res = convex_hull(points);
     }
+    print_hull(res);
 
 }
@@ -3,105 +3,23 @@
 #include <utility>
 #include <vector>
 #include <algorithm>
+#include <stdexcept>
 
-using namespace std;
-
-template<typename T>
-struct point_t {
-    T x;
-    T y;
-
-    point_t() : x(0), y(0) {}
-
-    point_t(T const &x, T const &y) : x(x), y(y) {}
-
-    point_t(point_t<T> const &other) = default;
-
-    template<typename U>
-    bool operator==(point_t<U> const &other) const {
-        return x == other.x && y == other.y;
-    }
-
-    T operator*(point_t const &other) const {
-        return x * other.x + y * other.y;
-    }
-
-    T operator/(point_t const &other) const {
-        return x * other.y - y * other.x;
-    }
+#include <cg/kernel.h>
+#include <cg/binary_io.h>
+#include <cg/point_location.h>
+#include <cg/geofence.h>
+#include <cg/polygon_scan.h>
 
-    point_t operator-(point_t const &other) const {
-        return point_t(x - other.x, y - other.y);
-    }
-
-    [[nodiscard]] T sqr_length() const {
-        return x * x + y * y;
-    }
-
-    template<typename U>
-    [[nodiscard]] point_t<U> to() const {
-        return point_t<U>{(U) (x), (U) y};
-    }
-};
-
-template<typename T>
-istream &operator>>(istream &in, point_t<T> &p) {
-    return in >> p.x >> p.y;
-}
-
-template<typename T>
-ostream &operator<<(ostream &out, point_t<T> const &p) {
-    return out << p.x << ' ' << p.y;
-}
+using namespace std;
+using namespace cg;
 
 typedef long long ll;
 typedef unsigned long long ull;
 typedef point_t<ll> point;
+typedef segment_t<ll> segment;
 
-struct segment_t {
-    point p1;
-    point p2;
-
-    [[nodiscard]] point vectorize() const {
-        return p2 - p1;
-    }
-
-    [[nodiscard]] bool contains(point const &p) const {
-        ll x1 = p1.x, y1 = p1.y;
-        ll x2 = p2.x, y2 = p2.y;
-        if (x2 < x1) {
-            swap(x1, x2);
-        }
-        if (y2 < y1) {
-            swap(y2, y1);
-        }
-        return (x1 <= p.x && p.x <= x2 && y1 <= p.y && p.y <= y2);
-    }
-};
-
-bool inside(vector<point> const &polygon, point const &p) {
-    bool count = false;
-    for (unsigned int i = 0; i < polygon.size(); i++) {
-        unsigned int j = (i > 0 ? i - 1 : polygon.size() - 1);
-        point p1 = polygon[j];
-        point p2 = polygon[i];
-        if (p2.y < p1.y) {
-            swap(p1, p2);
-        }
-        ll rotate = (p2 - p1) / (p - p1);
-        if (rotate == 0 && segment_t{p1, p2}.contains(p)) {
-            return true;
-        }
-        if (p1.y == p2.y || p.y == min(p1.y, p2.y)) {
-            continue;
-        } else if (rotate > 0 && p1.y < p.y && p.y <= p2.y) {
-            count ^= true;
-        }
-    }
-    return count;
-}
-
-int main() {
+int main(int argc, char **argv) {
 
     ios_base::sync_with_stdio(false);
     cin.tie(nullptr);
@@ -111,14 +29,64 @@ int main() {
     freopen("point.out", "w", stdout);
 #endif
 
-    unsigned int n;
+    tool_options options(argc, argv, {{"--zones"}, {"--nonzero"}});
+    if (!options) {
+        cerr << options.error() << '\n';
+        return 1;
+    }
+    if (options.is("--zones")) {
+        unsigned int m, k;
+        cin >> m;
+        vector<vector<point>> polygons(m);
+        for (vector<point> &polygon : polygons) {
+            unsigned int n;
+            cin >> n;
+            polygon.resize(n);
+            for (point &p : polygon) {
+                cin >> p;
+            }
+        }
+        cin >> k;
+        vector<point> queries(k);
+        for (point &p : queries) {
+            cin >> p;
+        }
+        thread_pool pool;
+        geofence_hits hits = geofence_index(polygons).query(queries.data(), queries.size(), pool);
+        for (unsigned int i = 0; i < k; i++) {
+            cout << hits.offset[i + 1] - hits.offset[i];
+            for (size_t j = hits.offset[i]; j < hits.offset[i + 1]; j++) {
+                cout << ' ' << hits.id[j];
+            }
+            cout << '\n';
+        }
+        return 0;
+    }
+
+    mapped_file binary = options.binary();
     point p0;
-    cin >> n >> p0;
-    vector<point> points(n);
-    for (point &p : points) {
-        cin >> p;
+    vector<point> points;
+    if (binary) {
+        array_view<point> query = binary.view<point>(0), input = binary.view<point>(1);
+        if (query.size() != 1) {
+            throw runtime_error("section 0 must hold exactly one point");
+        }
+        p0 = query[0];
+        points.assign(input.begin(), input.end());
+    } else {
+        unsigned int n;
+        cin >> n >> p0;
+        points.resize(n);
+        for (point &p : points) {
+            cin >> p;
+        }
+    }
+
+    if (points.empty()) {
+        throw runtime_error("the polygon has no vertices");
     }
 
-    cout << (inside(points, p0) ? "YES" : "NO") << '\n';
+    fill_rule rule = options.is("--nonzero") ? fill_rule::NONZERO : fill_rule::EVEN_ODD;
+    cout << (polygon_scan(points).locate(p0, rule) != position::OUTSIDE ? "YES" : "NO") << '\n';
 
 }
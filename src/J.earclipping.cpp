@@ -3,79 +3,20 @@
 #include <utility>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
 
-using namespace std;
-
-template<typename T>
-struct point_t {
-    T x;
-    T y;
-    unsigned int id{0};
-
-    point_t() : x(0), y(0) {}
-
-    point_t(T const &x, T const &y) : x(x), y(y) {}
-
-    point_t(point_t<T> const &other) = default;
-
-    template<typename U>
-    bool operator==(point_t<U> const &other) const {
-        return x == other.x && y == other.y;
-    }
-
-    T operator*(point_t const &other) const {
-        return x * other.x + y * other.y;
-    }
-
-    T operator/(point_t const &other) const {
-        return x * other.y - y * other.x;
-    }
+#include <cg/kernel.h>
+#include <cg/binary_io.h>
+#include <cg/triangulation.h>
 
-    point_t operator-(point_t const &other) const {
-        return point_t(x - other.x, y - other.y);
-    }
-
-    [[nodiscard]] T sqr_length() const {
-        return x * x + y * y;
-    }
-
-    template<typename U>
-    [[nodiscard]] point_t<U> to() const {
-        return point_t<U>{(U) (x), (U) y};
-    }
-};
-
-template<typename T>
-istream &operator>>(istream &in, point_t<T> &p) {
-    static unsigned int last_id = 1;
-    p.id = last_id++;
-    return in >> p.x >> p.y;
-}
-
-template<typename T>
-ostream &operator<<(ostream &out, point_t<T> const &p) {
-    return out << p.x << ' ' << p.y;
-}
+using namespace std;
+using namespace cg;
 
 typedef long long ll;
 typedef unsigned long long ull;
 
-struct point {
-    point_t<ll> data;
-    point *prev;
-    point *next;
-
-    point() : data(), prev(nullptr), next(nullptr) {}
-
-    explicit point(point *prev) : data(), prev(prev), next(nullptr) {}
-
-    explicit point(point_t<ll> const &data, point *prev) : data(data), prev(prev), next(nullptr) {}
-};
-
-int sign(long long value) {
-    return (value == 0 ? 0 : value < 0 ? -1 : 1);
-}
-
 bool inside(point_t<ll> const &p1, point_t<ll> const &p2, point_t<ll> const &p3, point_t<ll> const &p) {
     bool v1 = sign((p2 - p1) / (p3 - p1)) * sign((p2 - p1) / (p - p1)) >= 0;
     bool v2 = sign((p3 - p2) / (p1 - p2)) * sign((p3 - p2) / (p - p2)) >= 0;
@@ -83,38 +24,56 @@ bool inside(point_t<ll> const &p1, point_t<ll> const &p2, point_t<ll> const &p3,
     return v1 && v2 && v3;
 }
 
-bool check_ear(point *vertex, unsigned int n) {
-    point_t<ll> p1 = vertex->prev->data, p2 = vertex->data, p3 = vertex->next->data;
+bool check_ear(vector<point_t<ll>> const &points, polygon_ring const &ring, uint32_t vertex, unsigned int n) {
+    point_t<ll> p1 = points[ring.prev(vertex)], p2 = points[vertex], p3 = points[ring.next(vertex)];
     if ((p2 - p1) / (p3 - p2) < 0) {
         return false;
     }
-    point *cur = vertex->next->next;
+    uint32_t cur = ring.next(ring.next(vertex));
     for (unsigned int i = 0; i < n - 3; i++) {
-        if (inside(p1, p2, p3, cur->data)) {
+        if (inside(p1, p2, p3, points[cur])) {
             return false;
         }
-        cur = cur->next;
+        cur = ring.next(cur);
     }
     return true;
 }
 
-void triangulate(point *head, unsigned int n) {
-    point *cur = head;
+void triangulate(vector<point_t<ll>> const &points, polygon_ring &ring, vector<triangle> &result) {
+    auto n = (unsigned int) points.size();
+    ring.assign(n);
+    uint32_t cur = 0;
     while (n >= 3) {
-        if (check_ear(cur, n)) {
-            cout << cur->prev->data.id << ' ' << cur->data.id << ' ' << cur->next->data.id << '\n';
-            cur->prev->next = cur->next;
-            cur->next->prev = cur->prev;
-            delete cur;
+        if (check_ear(points, ring, cur, n)) {
+            result.push_back({ring.prev(cur), cur, ring.next(cur)});
+            ring.unlink(cur);
             n--;
-            cur = cur->prev;
+            cur = ring.prev(cur);
         } else {
-            cur = cur->next;
+            cur = ring.next(cur);
+        }
+    }
+}
+
+/*
+ * Polygon i of a batch is points[start[i], start[i + 1]); the offsets of a binary file are checked
+ * before anything is read through them.
+ */
+void check_offsets(vector<size_t> const &start, size_t points) {
+    if (start.empty() || start[0] != 0 || start.back() != points) {
+        throw runtime_error("polygon offsets do not cover the points");
+    }
+    for (size_t i = 0; i + 1 < start.size(); i++) {
+        if (start[i + 1] < start[i]) {
+            throw runtime_error("polygon offsets decrease");
+        }
+        if (start[i + 1] - start[i] > numeric_limits<uint32_t>::max()) {
+            throw runtime_error("polygon has more than 2^32 - 1 vertices");
         }
     }
 }
 
-int main() {
+int main(int argc, char **argv) {
 
     ios_base::sync_with_stdio(false);
     cin.tie(nullptr);
@@ -124,21 +83,89 @@ int main() {
     freopen("output.txt", "w", stdout);
 #endif
 
+    tool_options options(argc, argv, {{"--ears"}, {"--earcut"}, {"--batch"}});
+    if (!options) {
+        cerr << options.error() << '\n';
+        return 1;
+    }
+    mapped_file binary = options.binary();
+    if (options.is("--batch")) {
+        vector<point_t<ll>> points;
+        vector<size_t> start(1, 0);
+        if (binary) {
+            array_view<uint64_t> offsets = binary.view<uint64_t>(0);
+            array_view<point_t<ll>> input = binary.view<point_t<ll>>(1);
+            start.assign(offsets.begin(), offsets.end());
+            points.assign(input.begin(), input.end());
+            check_offsets(start, points.size());
+        } else {
+            unsigned int m;
+            cin >> m;
+            for (unsigned int i = 0; i < m; i++) {
+                unsigned int n;
+                cin >> n;
+                points.resize(points.size() + n);
+                for (size_t j = start.back(); j < points.size(); j++) {
+                    cin >> points[j];
+                }
+                start.push_back(points.size());
+            }
+        }
+        thread_pool pool;
+        triangulation_batch batch = triangulate_batch(points.data(), start.data(), start.size() - 1, pool);
+        if (binary) {
+            vector<uint64_t> vertices;
+            vertices.reserve(3 * batch.triangles.size());
+            for (size_t i = 0; i + 1 < start.size(); i++) {
+                for (size_t j = batch.offset[i]; j < batch.offset[i + 1]; j++) {
+                    for (uint32_t v : batch.triangles[j]) {
+                        vertices.push_back(start[i] + v);
+                    }
+                }
+            }
+            binary_writer writer(cout);
+            writer.write(vector<uint64_t>(batch.offset.begin(), batch.offset.end()));
+            writer.write(vertices);
+            return 0;
+        }
+        for (size_t i = 0; i + 1 < start.size(); i++) {
+            cout << batch.offset[i + 1] - batch.offset[i] << '\n';
+            for (size_t j = batch.offset[i]; j < batch.offset[i + 1]; j++) {
+                triangle const &t = batch.triangles[j];
+                cout << t[0] + 1 << ' ' << t[1] + 1 << ' ' << t[2] + 1 << '\n';
+            }
+        }
+        return 0;
+    }
+
+    array_view<point_t<ll>> input;
     unsigned int n;
-    cin >> n;
+    if (binary) {
+        input = binary.view<point_t<ll>>(0);
+        n = input.size();
+    } else {
+        cin >> n;
+    }
 
-    auto *head = new point();
-    point *cur = head;
+    vector<point_t<ll>> polygon(n);
     for (unsigned int i = 0; i < n; i++) {
-        cin >> cur->data;
-        if (i < n - 1) {
-            cur->next = new point(cur);
-            cur = cur->next;
+        if (binary) {
+            polygon[i] = input[i];
         } else {
-            cur->next = head;
-            head->prev = cur;
+            cin >> polygon[i];
         }
     }
-    triangulate(head, n);
+    vector<triangle> triangles;
+    if (options.is("--ears")) {
+        polygon_ring ring;
+        triangulate(polygon, ring, triangles);
+    } else if (options.is("--earcut")) {
+        triangulate_ears(polygon, triangles);
+    } else {
+        triangulate_monotone(polygon, triangles);
+    }
+    for (triangle const &t : triangles) {
+        cout << t[0] + 1 << ' ' << t[1] + 1 << ' ' << t[2] + 1 << '\n';
+    }
 
 }
@@ -4,65 +4,11 @@
 #include <algorithm>
 #include <cmath>
 
-using namespace std;
-
-template<typename T>
-struct point_t {
-    T x;
-    T y;
-    unsigned int id;
-
-    point_t() : x(0), y(0), id(0) {}
-
-    point_t(T const &x, T const &y) : x(x), y(y), id(0) {}
-
-    point_t(point_t<T> const &other) = default;
-
-    T operator*(point_t const &other) const {
-        return x * other.x + y * other.y;
-    }
-
-    T operator/(point_t const &other) const {
-        return x * other.y - y * other.x;
-    }
-
-    point_t operator+(point_t const &other) const {
-        return point_t(x + other.x, y + other.y);
-    }
-
-    point_t operator-(point_t const &other) const {
-        return point_t(x - other.x, y - other.y);
-    }
-
-    point_t operator-() const {
-        return point_t(-x, -y);
-    }
+#include <cg/kernel.h>
+#include <cg/binary_io.h>
 
-    [[nodiscard]] T sqr_length() const {
-        return x * x + y * y;
-    }
-
-    [[nodiscard]] T length() const {
-        return sqrt(sqr_length());
-    }
-
-    template<typename U>
-    [[nodiscard]] point_t<U> to() const {
-        return point_t<U>{(U) (x), (U) y};
-    }
-};
-
-template<typename T>
-istream &operator>>(istream &in, point_t<T> &p) {
-    static unsigned int last_id = 0;
-    p.id = last_id++;
-    return in >> p.x >> p.y;
-}
-
-template<typename T>
-ostream &operator<<(ostream &out, point_t<T> const &p) {
-    return out << p.x << ' ' << p.y;
-}
+using namespace std;
+using namespace cg;
 
 typedef long long ll;
 typedef long double ld;
@@ -117,7 +63,7 @@ unsigned int nearest(point const &p) {
     return res;
 }
 
-int main() {
+int main(int argc, char **argv) {
 
     ios_base::sync_with_stdio(false);
     cin.tie(nullptr);
@@ -127,21 +73,35 @@ int main() {
     freopen("output.txt", "w", stdout);
 #endif
 
-    unsigned int n, m;
-    cin >> n >> m;
-
-    vector<point> points(n);
-    for (point &p : points) {
-        cin >> p;
-    }
-    vector<point> queries(m);
-    for (point &p : queries) {
-        cin >> p;
+    tool_options options(argc, argv, {});
+    if (!options) {
+        cerr << options.error() << '\n';
+        return 1;
+    }
+    mapped_file binary = options.binary();
+    vector<point> points, queries;
+    if (binary) {
+        array_view<point> input = binary.view<point>(0);
+        points.assign(input.begin(), input.end());
+        input = binary.view<point>(1);
+        queries.assign(input.begin(), input.end());
+    } else {
+        unsigned int n, m;
+        cin >> n >> m;
+        points.resize(n);
+        for (point &p : points) {
+            cin >> p;
+        }
+        queries.resize(m);
+        for (point &p : queries) {
+            cin >> p;
+        }
     }
+    unsigned int n = points.size();
 
     lines.assign(2001, vector<int>(2001, -1));
-    for (point const &p : points) {
-        lines[p.y + 1000][p.x + 1000] = p.id;
+    for (unsigned int i = 0; i < n; i++) {
+        lines[points[i].y + 1000][points[i].x + 1000] = i;
     }
     l.assign(2001, vector<int>(2001, 2001));
     r.assign(2001, vector<int>(2001, 2001));
@@ -4,90 +4,19 @@
 #include <algorithm>
 #include <cmath>
 
-using namespace std;
-
-template<typename T>
-struct point_t {
-    T x;
-    T y;
-
-    point_t() : x(0), y(0) {}
-
-    point_t(T const &x, T const &y) : x(x), y(y) {}
-
-    point_t(point_t<T> const &other) = default;
-
-    T operator*(point_t const &other) const {
-        return x * other.x + y * other.y;
-    }
-
-    T operator/(point_t const &other) const {
-        return x * other.y - y * other.x;
-    }
-
-    point_t operator-(point_t const &other) const {
-        return point_t(x - other.x, y - other.y);
-    }
-
-    point_t operator-() const {
-        return point_t(-x, -y);
-    }
+#include <cg/kernel.h>
+#include <cg/binary_io.h>
+#include <cg/hull.h>
+#include <cg/streaming_hull.h>
 
-    [[nodiscard]] T sqr_length() const {
-        return x * x + y * y;
-    }
-
-    [[nodiscard]] T length() const {
-        return sqrt(sqr_length());
-    }
-
-    template<typename U>
-    [[nodiscard]] point_t<U> to() const {
-        return point_t<U>{(U) (x), (U) y};
-    }
-};
-
-template<typename T>
-istream &operator>>(istream &in, point_t<T> &p) {
-    return in >> p.x >> p.y;
-}
-
-template<typename T>
-ostream &operator<<(ostream &out, point_t<T> const &p) {
-    return out << p.x << ' ' << p.y;
-}
+using namespace std;
+using namespace cg;
 
 typedef long long ll;
 typedef long double ld;
 typedef unsigned long long ull;
 typedef point_t<ll> point;
 
-vector<point> convex_hull(vector<point> &points) {
-    point p = *min_element(points.begin(), points.end(), [](point const &p1, point const &p2) {
-        return p1.y < p2.y || (p1.y == p2.y && p1.x > p2.x);
-    });
-    sort(points.begin(), points.end(), [&p](point const &p1, point const &p2) {
-        ll rotate = (p1 - p) / (p2 - p);
-        return rotate > 0 || (rotate == 0 && (p1 - p).to<ull>().sqr_length() < (p2 - p).to<ull>().sqr_length());
-    });
-    vector<point> result{p};
-    for (unsigned int i = 1; i < points.size(); i++) {
-        point next = points[i];
-        while (result.size() >= 2) {
-            point v_prev = result.back() - result[result.size() - 2];
-            point v_next = next - result.back();
-            ll rotate = v_next / v_prev;
-            if (rotate >= 0) {
-                result.pop_back();
-            } else {
-                break;
-            }
-        }
-        result.push_back(next);
-    }
-    return result;
-}
-
 ull sqr_diameter(vector<point> &polygon) {
     unsigned int x = 0, y = 0;
     ull result = 0;
@@ -105,7 +34,17 @@ ull sqr_diameter(vector<point> &polygon) {
     return result;
 }
 
-int main() {
+double diameter(vector<point> &polygon) {
+    if (polygon.size() == 1) {
+        return 0;
+    } else if (polygon.size() == 2) {
+        return (polygon[0] - polygon[1]).to<double>().length();
+    } else {
+        return sqrt((double) sqr_diameter(polygon));
+    }
+}
+
+int main(int argc, char **argv) {
 
     ios_base::sync_with_stdio(false);
     cin.tie(nullptr);
@@ -115,22 +54,56 @@ int main() {
     freopen("diameter.out", "w", stdout);
 #endif
 
-    unsigned int n;
-    cin >> n;
-
-    vector<point> points(n);
-    for (point &p : points) {
-        cin >> p;
+    tool_options options(argc, argv, {{"--stream", "", "uu"}});
+    if (!options) {
+        cerr << options.error() << '\n';
+        return 1;
+    }
+    mapped_file binary = options.binary();
+    array_view<point> input;
+    if (binary) {
+        input = binary.view<point>(0);
     }
-    auto polygon = convex_hull(points);
 
-    cout.precision(1000);
-    if (polygon.size() == 1) {
-        cout << "0\n";
-    } else if (polygon.size() == 2) {
-        cout << (polygon[0] - polygon[1]).to<double>().length() << '\n';
+    vector<point> polygon;
+    if (options.is("--stream")) {
+        size_t chunk = options.unsigned_argument(0, 1u << 20);
+        unsigned long long checkpoint = options.unsigned_argument(1, 0);
+        streaming_hull hull(chunk);
+        unsigned long long i = 0;
+        auto push = [&](point const &p) {
+            hull.push(p);
+            if (checkpoint != 0 && ++i % checkpoint == 0) {
+                polygon = hull.hull();
+                cerr << i << " points: diameter " << diameter(polygon) << '\n';
+            }
+        };
+        if (binary) {
+            for (point const &p : input) {
+                push(p);
+            }
+        } else {
+            point_stream<ll> in(cin);
+            point p;
+            while (in.next(p)) {
+                push(p);
+            }
+        }
+        polygon = hull.hull();
     } else {
-        cout << sqrt((double) sqr_diameter(polygon)) << '\n';
+        vector<point> points(input.begin(), input.end());
+        if (!binary) {
+            unsigned int n;
+            cin >> n;
+            points.resize(n);
+            for (point &p : points) {
+                cin >> p;
+            }
+        }
+        polygon = convex_hull(points);
     }
 
+    cout.precision(1000);
+    cout << diameter(polygon) << '\n';
+
 }
@@ -6,84 +6,31 @@
 #include <set>
 #include <map>
 
+#include <cg/kernel.h>
+#include <cg/binary_io.h>
+
 using namespace std;
+using namespace cg;
 
 long double eps = 1e-10;
 
-template<typename T>
-struct point_t {
-    T x;
-    T y;
-
-    point_t() : x(0), y(0) {}
-
-    point_t(T const &x, T const &y) : x(x), y(y) {}
-
-    point_t(point_t<T> const &other) = default;
-
-    T operator*(point_t const &other) const {
-        return x * other.x + y * other.y;
-    }
-
-    T operator/(point_t const &other) const {
-        return x * other.y - y * other.x;
-    }
-
-    point_t operator-(point_t const &other) const {
-        return point_t(x - other.x, y - other.y);
-    }
-
-    point_t operator-() const {
-        return point_t(-x, -y);
-    }
-
-    [[nodiscard]] T sqr_length() const {
-        return x * x + y * y;
-    }
-
-    [[nodiscard]] T length() const {
-        return sqrt(sqr_length());
-    }
-
-    template<typename U>
-    [[nodiscard]] point_t<U> to() const {
-        return point_t<U>{(U) (x), (U) y};
-    }
-
-    bool operator<(point_t<T> const &other) const {
-        return other.x - x > eps || (abs(x - other.x) < eps && other.y - y > eps);
-    }
-
-    bool operator==(point_t<T> const &other) const {
-        return abs(x - other.x) < eps && abs(y - other.y) < eps;
-    }
-
-    bool operator!=(point_t<T> const &other) const {
-        return !(*this == other);
-    }
+typedef long long ll;
+typedef long double ld;
+typedef unsigned long long ull;
+typedef point_t<ld> point;
 
-    long double atan() const {
-        return atan2(y, x);
+struct eps_less {
+    bool operator()(point const &p1, point const &p2) const {
+        return p2.x - p1.x > eps || (abs(p1.x - p2.x) < eps && p2.y - p1.y > eps);
     }
 };
 
-template<typename T>
-istream &operator>>(istream &in, point_t<T> &p) {
-    return in >> p.x >> p.y;
+bool same(point const &p1, point const &p2) {
+    return abs(p1.x - p2.x) < eps && abs(p1.y - p2.y) < eps;
 }
 
-template<typename T>
-ostream &operator<<(ostream &out, point_t<T> const &p) {
-    return out << p.x << ' ' << p.y;
-}
-
-typedef long long ll;
-typedef long double ld;
-typedef unsigned long long ull;
-typedef point_t<ld> point;
-
-int sign(long double value) {
-    return (value == 0 ? 0 : value > 0 ? 1 : -1);
+ld angle(point const &p) {
+    return atan2(p.y, p.x);
 }
 
 ld det(ld a, ld b, ld c, ld d) {
@@ -123,7 +70,7 @@ ld go(vector<point> const &points, vector<vector<unsigned int>> const &graph, ve
         auto edge = upper_bound(
                 graph[next].begin(), graph[next].end(), i,
                 [next, &points](unsigned int p1, unsigned int p2) {
-                    return (points[p1] - points[next]).atan() < (points[p2] - points[next]).atan();
+                    return angle(points[p1] - points[next]) < angle(points[p2] - points[next]);
                 }
         );
         unsigned int idx = (edge - graph[next].begin()) % graph[next].size();
@@ -147,7 +94,7 @@ ld go(vector<point> const &points, vector<vector<unsigned int>> const &graph, ve
 
 vector<ld> areas(vector<line> const &lines) {
     vector<point> points;
-    map<point, unsigned int> ids;
+    map<point, unsigned int, eps_less> ids;
     vector<vector<unsigned int>> graph;
 
     for (unsigned int i = 0; i < lines.size(); i++) {
@@ -164,13 +111,13 @@ vector<ld> areas(vector<line> const &lines) {
             }
         }
 
-        sort(cur.begin(), cur.end());
+        sort(cur.begin(), cur.end(), eps_less());
         while (graph.size() < points.size()) {
             graph.emplace_back();
         }
         for (unsigned int j = 1; j < cur.size(); j++) {
             unsigned int k1 = ids[cur[j - 1]], k2 = ids[cur[j]];
-            if (points[k1] != points[k2]) {
+            if (!same(points[k1], points[k2])) {
                 graph[k1].emplace_back(k2);
                 graph[k2].emplace_back(k1);
             }
@@ -181,7 +128,7 @@ vector<ld> areas(vector<line> const &lines) {
     vector<vector<bool>> vis(n);
     for (unsigned int i = 0; i < n; i++) {
         sort(graph[i].begin(), graph[i].end(), [i, &points](unsigned int p1, unsigned int p2) {
-            return (points[p1] - points[i]).atan() < (points[p2] - points[i]).atan();
+            return angle(points[p1] - points[i]) < angle(points[p2] - points[i]);
         });
         vis[i].assign(graph[i].size(), false);
     }
@@ -210,7 +157,7 @@ vector<ld> areas(vector<line> const &lines) {
     }
 }
 
-int main() {
+int main(int argc, char **argv) {
 
     ios_base::sync_with_stdio(false);
     cin.tie(nullptr);
@@ -220,14 +167,25 @@ int main() {
     freopen("output.txt", "w", stdout);
 #endif
 
-    unsigned int n;
-    cin >> n;
-
+    tool_options options(argc, argv, {});
+    if (!options) {
+        cerr << options.error() << '\n';
+        return 1;
+    }
+    mapped_file binary = options.binary();
     vector<line> lines;
-    for (unsigned int i = 0; i < n; i++) {
-        point p1, p2;
-        cin >> p1 >> p2;
-        lines.emplace_back(p1, p2);
+    if (binary) {
+        for (segment_t<double> const &s : binary.view<segment_t<double>>(0)) {
+            lines.emplace_back(s.p1.to<ld>(), s.p2.to<ld>());
+        }
+    } else {
+        unsigned int n;
+        cin >> n;
+        for (unsigned int i = 0; i < n; i++) {
+            point p1, p2;
+            cin >> p1 >> p2;
+            lines.emplace_back(p1, p2);
+        }
     }
 
     auto res = areas(lines);
@@ -5,67 +5,11 @@
 #include <vector>
 #include <algorithm>
 
-using namespace std;
-
-template<typename T>
-struct point_t {
-    T x;
-    T y;
-
-    point_t() : x(0), y(0) {}
-
-    point_t(T const &x, T const &y) : x(x), y(y) {}
-
-    point_t(point_t<T> const &other) = default;
-
-    template<typename U>
-    bool operator==(point_t<U> const &other) const {
-        return x == other.x && y == other.y;
-    }
-
-    T operator*(point_t const &other) const {
-        return x * other.x + y * other.y;
-    }
-
-    T operator/(point_t const &other) const {
-        return x * other.y - y * other.x;
-    }
-
-    point_t operator-(point_t const &other) const {
-        return point_t(x - other.x, y - other.y);
-    }
-
-    point_t operator+(point_t const &other) const {
-        return point_t(x + other.x, y + other.y);
-    }
+#include <cg/kernel.h>
+#include <cg/binary_io.h>
 
-    point_t operator*(T const &number) const {
-        return point_t(x * number, y * number);
-    }
-
-    [[nodiscard]] T sqr_length() const {
-        return sqrt(sqr_length());
-    }
-
-    [[nodiscard]] T sqr_length() const {
-        return x * x + y * y;
-    }
-
-    template<typename U>
-    [[nodiscard]] point_t<U> to() const {
-        return point_t<U>{(U) (x), (U) y};
-    }
-};
-
-template<typename T>
-istream &operator>>(istream &in, point_t<T> &p) {
-    return in >> p.x >> p.y;
-}
-
-template<typename T>
-ostream &operator<<(ostream &out, point_t<T> const &p) {
-    return out << p.x << ' ' << p.y;
-}
+using namespace std;
+using namespace cg;
 
 typedef long long ll;
 typedef long double ld;
@@ -128,7 +72,7 @@ circle min_disc(vector<point> &points) {
     return res;
 }
 
-int main() {
+int main(int argc, char **argv) {
 
     ios_base::sync_with_stdio(false);
     cin.tie(nullptr);
@@ -138,11 +82,23 @@ int main() {
     freopen("tower.out", "w", stdout);
 #endif
 
-    unsigned int n;
-    cin >> n;
-    vector<point> points(n);
-    for (point &p : points) {
-        cin >> p;
+    tool_options options(argc, argv, {});
+    if (!options) {
+        cerr << options.error() << '\n';
+        return 1;
+    }
+    mapped_file binary = options.binary();
+    vector<point> points;
+    if (binary) {
+        array_view<point> input = binary.view<point>(0);
+        points.assign(input.begin(), input.end());
+    } else {
+        unsigned int n;
+        cin >> n;
+        points.resize(n);
+        for (point &p : points) {
+            cin >> p;
+        }
     }
 
     circle res = points.size() > 1 ? min_disc(points) : circle(points[0].to<ld>(), 0);
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+
+/*
+ * Minimal test harness: a test program calls check for every property and returns result().
+ */
+namespace cg_test {
+
+inline unsigned long long &failures() {
+    static unsigned long long count = 0;
+    return count;
+}
+
+inline void check(bool ok, std::string const &what) {
+    if (!ok && failures()++ < 20) {
+        std::cerr << "FAIL: " << what << '\n';
+    }
+}
+
+inline int result(char const *name) {
+    if (failures() != 0) {
+        std::cerr << name << ": " << failures() << " failures\n";
+        return 1;
+    }
+    std::cout << name << ": ok\n";
+    return 0;
+}
+
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cg/dynamic_hull.h>
+#include <cg/hull.h>
+#include <cg/segment.h>
+
+#include "check.h"
+
+using namespace std;
+using namespace cg;
+using namespace cg_test;
+
+typedef point_t<long long> point;
+
+/*
+ * Whether q lies in the closed convex polygon hull (counter-clockwise, strictly convex).
+ */
+bool brute_contains(vector<point> const &hull, point const &q) {
+    if (hull.size() == 1) {
+        return hull[0] == q;
+    }
+    if (hull.size() == 2) {
+        return orientation(hull[0], hull[1], q) == 0 && segment_t<long long>{hull[0], hull[1]}.contains(q);
+    }
+    for (size_t i = 0; i < hull.size(); i++) {
+        if (orientation(hull[i], hull[(i + 1) % hull.size()], q) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    mt19937_64 random(20240604);
+    for (int round = 0; round < 60; round++) {
+        long long side = round % 2 == 0 ? 8 : 1000;
+        uniform_int_distribution<long long> coordinate(-side, side), direction(-5, 5);
+        dynamic_hull hull;
+        vector<point> points;
+        for (int step = 0; step < 400; step++) {
+            string name = "round " + to_string(round) + " step " + to_string(step);
+            if (points.empty() || random() % 3 != 0) {
+                point p(coordinate(random), coordinate(random));
+                hull.insert(p);
+                points.push_back(p);
+            } else if (random() % 8 == 0) {
+                point p(coordinate(random), coordinate(random));
+                bool present = find(points.begin(), points.end(), p) != points.end();
+                check(hull.erase(p) == present, name + ": erase result");
+                if (present) {
+                    points.erase(find(points.begin(), points.end(), p));
+                }
+            } else {
+                size_t k = random() % points.size();
+                check(hull.erase(points[k]), name + ": erase of a present point");
+                points.erase(points.begin() + k);
+            }
+
+            vector<point> copy = points;
+            vector<point> expected = points.empty() ? vector<point>() : convex_hull(copy);
+            check(hull.points() == points.size(), name + ": points()");
+            check(hull.hull() == expected, name + ": hull()");
+            vector<point> vertices = expected;
+            sort(vertices.begin(), vertices.end(), detail::lexicographic_less);
+            vertices.erase(unique(vertices.begin(), vertices.end()), vertices.end());
+            check(hull.size() == vertices.size(), name + ": size() counts distinct vertices");
+            if (points.empty()) {
+                continue;
+            }
+
+            point q(coordinate(random) * 3 / 2, coordinate(random) * 3 / 2);
+            bool inside = brute_contains(expected, q);
+            check(hull.contains(q) == inside, name + ": contains");
+            point d(direction(random), direction(random));
+            if (d != point(0, 0)) {
+                point e = hull.extreme(d);
+                long long best = d * expected[0];
+                for (point const &p : expected) {
+                    best = max(best, d * p);
+                }
+                check(d * e == best && find(expected.begin(), expected.end(), e) != expected.end(),
+                      name + ": extreme");
+            }
+            if (!inside) {
+                pair<point, point> t = hull.tangents(q);
+                bool first = find(expected.begin(), expected.end(), t.first) != expected.end();
+                bool second = find(expected.begin(), expected.end(), t.second) != expected.end();
+                for (point const &p : expected) {
+                    first &= orientation(q, t.first, p) >= 0;
+                    second &= orientation(q, t.second, p) <= 0;
+                }
+                check(first && second, name + ": tangents");
+            }
+        }
+    }
+    return result("dynamic_hull");
+}
@@ -0,0 +1,99 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include <cg/hull.h>
+#include <cg/point_location.h>
+#include <cg/polygon_scan.h>
+
+#include "check.h"
+#include "random_polygons.h"
+
+using namespace std;
+using namespace cg;
+using namespace cg_test;
+
+/*
+ * BORDER on any edge, otherwise the parity of the edges crossing the ray to the right of p.
+ */
+position brute_locate(vector<point> const &polygon, point const &p) {
+    size_t n = polygon.size();
+    bool inside = false;
+    for (size_t i = 0; i < n; i++) {
+        point a = polygon[i], b = polygon[(i + 1) % n];
+        long long o = orientation(a, b, p);
+        if (o == 0 && segment_t<long long>{a, b}.contains(p)) {
+            return position::BORDER;
+        }
+        if (a.y <= p.y && p.y < b.y && o > 0) {
+            inside = !inside;
+        } else if (b.y <= p.y && p.y < a.y && o < 0) {
+            inside = !inside;
+        }
+    }
+    return inside ? position::INSIDE : position::OUTSIDE;
+}
+
+/*
+ * Random points around the polygon, its vertices, the lattice points near them and the middles
+ * of its edges, so that borders and vertex ordinates are hit often.
+ */
+vector<point> queries_for(mt19937_64 &random, vector<point> const &polygon) {
+    point lo = polygon[0], hi = polygon[0];
+    for (point const &p : polygon) {
+        lo = point(min(lo.x, p.x), min(lo.y, p.y));
+        hi = point(max(hi.x, p.x), max(hi.y, p.y));
+    }
+    uniform_int_distribution<long long> x(lo.x - 2, hi.x + 2), y(lo.y - 2, hi.y + 2);
+    vector<point> result;
+    for (int i = 0; i < 200; i++) {
+        result.emplace_back(x(random), y(random));
+    }
+    for (size_t i = 0; i < polygon.size(); i++) {
+        point a = polygon[i], b = polygon[(i + 1) % polygon.size()];
+        result.push_back(a);
+        result.emplace_back(a.x + 1, a.y);
+        result.emplace_back(a.x - 1, a.y);
+        result.emplace_back(x(random), a.y);
+        if ((a.x + b.x) % 2 == 0 && (a.y + b.y) % 2 == 0) {
+            result.emplace_back((a.x + b.x) / 2, (a.y + b.y) / 2);
+        }
+    }
+    return result;
+}
+
+int main() {
+    mt19937_64 random(20240602);
+    for (int round = 0; round < 400; round++) {
+        vector<point> polygon = random_simple_polygon(random, round < 300 ? 30 : 200);
+        if (polygon.empty()) {
+            continue;
+        }
+        string name = "polygon " + to_string(round);
+        polygon_locator slabs(polygon);
+        polygon_scan scan(polygon);
+        for (point const &q : queries_for(random, polygon)) {
+            position expected = brute_locate(polygon, q);
+            check(slabs.locate(q) == expected, name + ": polygon_locator");
+            check(scan.locate(q, fill_rule::EVEN_ODD) == expected, name + ": polygon_scan even-odd");
+            check(scan.locate(q, fill_rule::NONZERO) == expected, name + ": polygon_scan nonzero");
+            check(scan.locate(q, fill_rule::EVEN_ODD, simd_level::SCALAR) == expected, name + ": polygon_scan scalar");
+        }
+
+        vector<point> hull = polygon;
+        hull = convex_hull(hull);
+        if (hull.size() < 3) {
+            continue;
+        }
+        convex_locator convex(hull);
+        vector<point> queries = queries_for(random, hull);
+        vector<position> batch(queries.size());
+        convex.locate(queries.data(), queries.size(), batch.data());
+        for (size_t i = 0; i < queries.size(); i++) {
+            position expected = brute_locate(hull, queries[i]);
+            check(convex.locate(queries[i]) == expected, name + ": convex_locator");
+            check(batch[i] == expected, name + ": convex_locator batch");
+        }
+    }
+    return result("point_location");
+}
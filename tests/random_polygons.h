@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <cg/intersection.h>
+#include <cg/point.h>
+#include <cg/segment.h>
+
+/*
+ * Random simple polygons with many degeneracies (collinear runs, equal coordinates), checked by
+ * brute force.
+ */
+namespace cg_test {
+
+typedef cg::point_t<long long> point;
+
+/*
+ * Distinct vertices, adjacent edges meeting only at their common vertex, other edges disjoint.
+ */
+inline bool is_simple(std::vector<point> const &polygon) {
+    std::size_t n = polygon.size();
+    if (n < 3) {
+        return false;
+    }
+    auto edge = [&](std::size_t i) {
+        return cg::segment_t<long long>{polygon[i], polygon[(i + 1) % n]};
+    };
+    for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t j = i + 1; j < n; j++) {
+            if (polygon[i] == polygon[j]) {
+                return false;
+            }
+            bool adjacent = j == i + 1 || (i == 0 && j == n - 1);
+            if (!adjacent) {
+                if (cg::intersects(edge(i), edge(j))) {
+                    return false;
+                }
+                continue;
+            }
+            std::size_t first = j == i + 1 ? i : j, second = j == i + 1 ? j : i;
+            point a = polygon[first], b = polygon[second], c = polygon[(second + 1) % n];
+            if (orientation(a, b, c) == 0 && (a - b) * (c - b) > 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*
+ * Star-shaped around the origin: jittered, evenly spaced angles and random radii.
+ */
+inline std::vector<point> star_polygon(std::mt19937_64 &random, std::size_t n, double radius) {
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::vector<point> result;
+    for (std::size_t i = 0; i < n; i++) {
+        double angle = 2 * M_PI * (i + 0.9 * unit(random)) / n, r = (0.1 + 0.9 * unit(random)) * radius;
+        point p((long long) std::lround(r * std::cos(angle)), (long long) std::lround(r * std::sin(angle)));
+        if (result.empty() || result.back() != p) {
+            result.push_back(p);
+        }
+    }
+    while (result.size() > 1 && result.back() == result.front()) {
+        result.pop_back();
+    }
+    return result;
+}
+
+/*
+ * Distinct random grid points untangled by 2-opt: a proper crossing is removed by reversing the
+ * path between the two edges.
+ */
+inline std::vector<point> two_opt_polygon(std::mt19937_64 &random, std::size_t n, long long side) {
+    std::uniform_int_distribution<long long> coordinate(0, side);
+    std::vector<point> result;
+    while (result.size() < n) {
+        point p(coordinate(random), coordinate(random));
+        if (std::find(result.begin(), result.end(), p) == result.end()) {
+            result.push_back(p);
+        }
+    }
+    auto proper = [](point const &a, point const &b, point const &c, point const &d) {
+        long long d1 = orientation(c, d, a), d2 = orientation(c, d, b);
+        long long d3 = orientation(a, b, c), d4 = orientation(a, b, d);
+        return ((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0));
+    };
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (std::size_t i = 0; i < n; i++) {
+            for (std::size_t j = i + 2; j < n; j++) {
+                if (i == 0 && j == n - 1) {
+                    continue;
+                }
+                if (proper(result[i], result[i + 1], result[j], result[(j + 1) % n])) {
+                    std::reverse(result.begin() + i + 1, result.begin() + j + 1);
+                    changed = true;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+/*
+ * Comb: a long bottom edge and teeth of random heights, full of collinear vertices.
+ */
+inline std::vector<point> comb_polygon(std::mt19937_64 &random, std::size_t teeth) {
+    std::uniform_int_distribution<long long> height(1, 5);
+    long long k = (long long) std::max<std::size_t>(teeth, 2);
+    std::vector<point> result = {point(0, 0), point(2 * k, 0)};
+    for (long long i = k - 1; i >= 0; i--) {
+        long long t = height(random);
+        result.emplace_back(2 * i + 2, t + 1);
+        if (i > 0) {
+            result.emplace_back(2 * i + 1, t + 1 + (long long) (random() % 2));
+            result.emplace_back(2 * i + 1, 1);
+        } else {
+            result.emplace_back(0, t + 1);
+        }
+    }
+    std::vector<point> unique;
+    for (point const &p : result) {
+        if (unique.empty() || unique.back() != p) {
+            unique.push_back(p);
+        }
+    }
+    return unique;
+}
+
+/*
+ * One of the shapes above, in either orientation and starting at any vertex; empty if the
+ * attempt was not simple.
+ */
+inline std::vector<point> random_simple_polygon(std::mt19937_64 &random, std::size_t max_vertices) {
+    std::size_t n = 3 + random() % (max_vertices - 2);
+    std::vector<point> result;
+    switch (random() % 3) {
+        case 0:
+            result = star_polygon(random, n, std::pow(10.0, 1 + (double) (random() % 8)));
+            break;
+        case 1:
+            result = two_opt_polygon(random, n, (long long) (n * (1 + random() % 10)));
+            break;
+        default:
+            result = comb_polygon(random, n / 4);
+            break;
+    }
+    if (random() % 2 == 0) {
+        std::reverse(result.begin(), result.end());
+    }
+    if (!result.empty()) {
+        std::rotate(result.begin(), result.begin() + random() % result.size(), result.end());
+    }
+    return is_simple(result) ? result : std::vector<point>();
+}
+
+}
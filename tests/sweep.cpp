@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cg/intersection.h>
+#include <cg/sweep.h>
+
+#include "check.h"
+
+using namespace std;
+using namespace cg;
+using namespace cg_test;
+
+typedef segment_t<double> segment;
+
+/*
+ * Segments on a small lattice, so that shared endpoints, collinear overlaps, verticals and
+ * crossings of three or more segments at one point are common; or with arbitrary doubles.
+ */
+vector<segment> random_segments(mt19937_64 &random, size_t n, bool lattice) {
+    uniform_int_distribution<int> grid(0, (int) max<size_t>(4, n / 3));
+    uniform_real_distribution<double> real(-1e6, 1e6);
+    vector<segment> result;
+    while (result.size() < n) {
+        segment s;
+        if (lattice) {
+            s = {{(double) grid(random), (double) grid(random)}, {(double) grid(random), (double) grid(random)}};
+        } else {
+            s = {{real(random), real(random)}, {real(random), real(random)}};
+        }
+        if (s.p1 != s.p2) {
+            result.push_back(s);
+        }
+    }
+    return result;
+}
+
+int main() {
+    mt19937_64 random(20240603);
+    for (int round = 0; round < 300; round++) {
+        vector<segment> segments = random_segments(random, 2 + random() % 60, round % 3 != 0);
+        vector<pair<unsigned int, unsigned int>> expected, reported;
+        for (unsigned int i = 0; i < segments.size(); i++) {
+            for (unsigned int j = i + 1; j < segments.size(); j++) {
+                if (intersects(segments[i], segments[j])) {
+                    expected.emplace_back(i, j);
+                }
+            }
+        }
+        report_intersections(segments, [&reported](unsigned int i, unsigned int j) {
+            reported.emplace_back(i, j);
+        });
+        sort(reported.begin(), reported.end());
+        string name = "round " + to_string(round);
+        check(adjacent_find(reported.begin(), reported.end()) == reported.end(), name + ": pair reported twice");
+        reported.erase(unique(reported.begin(), reported.end()), reported.end());
+        check(reported == expected, name + ": reported pairs differ from brute force");
+        check(count_intersections(segments) == expected.size(), name + ": count_intersections");
+    }
+    return result("sweep");
+}
@@ -0,0 +1,84 @@
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cg/parallel.h>
+#include <cg/triangulation.h>
+
+#include "check.h"
+#include "random_polygons.h"
+
+using namespace std;
+using namespace cg;
+using namespace cg_test;
+
+/*
+ * n - 2 counter-clockwise (possibly flat) triangles covering the area, every polygon edge used
+ * once in counter-clockwise direction and every diagonal once in each direction.
+ */
+void check_triangulation(vector<point> const &polygon, vector<triangle> const &triangles, string const &name) {
+    size_t n = polygon.size();
+    __int128 area = 0, total = 0;
+    for (size_t i = 0; i < n; i++) {
+        area += (__int128) (polygon[i] / polygon[(i + 1) % n]);
+    }
+    check(triangles.size() == n - 2, name + ": triangle count");
+    map<pair<uint32_t, uint32_t>, int> edges;
+    for (triangle const &t : triangles) {
+        if (t[0] >= n || t[1] >= n || t[2] >= n) {
+            check(false, name + ": vertex index out of range");
+            return;
+        }
+        long long o = orientation(polygon[t[0]], polygon[t[1]], polygon[t[2]]);
+        check(o >= 0, name + ": clockwise triangle");
+        total += o;
+        for (int k = 0; k < 3; k++) {
+            edges[{t[k], t[(k + 1) % 3]}]++;
+        }
+    }
+    check(total == (area < 0 ? -area : area), name + ": area");
+    for (size_t i = 0; i < n; i++) {
+        auto e = area > 0 ? make_pair((uint32_t) i, (uint32_t) ((i + 1) % n))
+                          : make_pair((uint32_t) ((i + 1) % n), (uint32_t) i);
+        check(edges[e] == 1, name + ": polygon edge " + to_string(i));
+    }
+    for (auto const &e : edges) {
+        uint32_t u = e.first.first, v = e.first.second;
+        bool boundary = area > 0 ? v == (u + 1) % n : u == (v + 1) % n;
+        check(e.second == 1, name + ": repeated edge");
+        if (!boundary) {
+            auto back = edges.find({v, u});
+            check(back != edges.end() && back->second == 1, name + ": unmatched diagonal");
+        }
+    }
+}
+
+int main() {
+    mt19937_64 random(20240601);
+    thread_pool pool(4);
+    vector<point> points;
+    vector<size_t> start(1, 0);
+    vector<vector<triangle>> expected;
+    for (int round = 0; round < 600; round++) {
+        vector<point> polygon = random_simple_polygon(random, round < 500 ? 40 : 300);
+        if (polygon.empty()) {
+            continue;
+        }
+        string name = "polygon " + to_string(round);
+        check_triangulation(polygon, triangulate_monotone(polygon), name + " monotone");
+        vector<triangle> ears = triangulate_ears(polygon);
+        check_triangulation(polygon, ears, name + " ears");
+        points.insert(points.end(), polygon.begin(), polygon.end());
+        start.push_back(points.size());
+        expected.push_back(ears);
+    }
+
+    triangulation_batch batch = triangulate_batch(points.data(), start.data(), start.size() - 1, pool);
+    for (size_t i = 0; i + 1 < start.size(); i++) {
+        vector<triangle> got(batch.triangles.begin() + batch.offset[i], batch.triangles.begin() + batch.offset[i + 1]);
+        check(got == expected[i], "batch polygon " + to_string(i) + " differs from triangulate_ears");
+    }
+    return result("triangulation");
+}
@@ -0,0 +1,142 @@
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <cg/kernel.h>
+#include <cg/binary_io.h>
+
+using namespace std;
+using namespace cg;
+
+typedef long long ll;
+
+/*
+ * Converts the text input of a task to a binary file for its "--binary" option.
+ *
+ *   cg_convert <task> [input [output]]
+ *
+ * Input layouts, as sections of the output:
+ *   C E J L N  -- n, n points                     -> points
+ *   H          -- n, n points, k, k points        -> polygon, queries
+ *   I          -- n, a point, n points            -> the point, polygon
+ *   K          -- n m, n points, m points         -> points, queries
+ *   M          -- n, n segments                   -> float64 segments
+ *   G          -- n, n lines "a b c"              -> float64 lines
+ *   J-batch    -- m, m times (n, n points)        -> uint64 offsets (m + 1), points
+ */
+
+struct step {
+    char what;          // 'n' reads a count; 'p', 's', 'l' write points, segments, lines;
+                        // 'm' writes that many polygons as offsets and points
+    int count;          // index of the count read before, or -1 for a single element
+};
+
+map<string, vector<step>> const layouts = {
+        {"C", {{'n', 0}, {'p', 0}}},
+        {"E", {{'n', 0}, {'p', 0}}},
+        {"J", {{'n', 0}, {'p', 0}}},
+        {"L", {{'n', 0}, {'p', 0}}},
+        {"N", {{'n', 0}, {'p', 0}}},
+        {"H", {{'n', 0}, {'p', 0}, {'n', 0}, {'p', 1}}},
+        {"I", {{'n', 0}, {'p', -1}, {'p', 0}}},
+        {"K", {{'n', 0}, {'n', 0}, {'p', 0}, {'p', 1}}},
+        {"M", {{'n', 0}, {'s', 0}}},
+        {"G", {{'n', 0}, {'l', 0}}},
+        {"J-batch", {{'n', 0}, {'m', 0}}},
+};
+
+template<typename T, typename Read>
+void convert(istream &in, binary_writer &out, size_t count, Read read) {
+    vector<T> elements(count);
+    for (T &e : elements) {
+        read(in, e);
+    }
+    if (!in) {
+        throw runtime_error("input ended early");
+    }
+    out.write(elements);
+}
+
+int main(int argc, char **argv) {
+
+    ios_base::sync_with_stdio(false);
+
+    if (argc < 2 || layouts.count(argv[1]) == 0) {
+        cerr << "usage: " << argv[0] << " <task> [input [output]]\n";
+        return 1;
+    }
+
+    ifstream file_in;
+    ofstream file_out;
+    if (argc > 2) {
+        file_in.open(argv[2]);
+    }
+    if (argc > 3) {
+        file_out.open(argv[3], ios::binary);
+    }
+    istream &in = argc > 2 ? file_in : cin;
+    ostream &out = argc > 3 ? file_out : cout;
+    if (!in || !out) {
+        cerr << "cannot open " << argv[in ? 3 : 2] << '\n';
+        return 1;
+    }
+
+    try {
+        binary_writer writer(out);
+        vector<size_t> counts;
+        for (step const &s : layouts.at(argv[1])) {
+            size_t count = s.count < 0 ? 1 : s.what == 'n' ? 0 : counts.at(s.count);
+            switch (s.what) {
+                case 'n':
+                    counts.emplace_back();
+                    in >> counts.back();
+                    break;
+                case 'p':
+                    convert<point_t<ll>>(in, writer, count, [](istream &in, point_t<ll> &p) {
+                        in >> p;
+                    });
+                    break;
+                case 's':
+                    convert<segment_t<double>>(in, writer, count, [](istream &in, segment_t<double> &s) {
+                        in >> s.p1 >> s.p2;
+                    });
+                    break;
+                case 'l':
+                    convert<line_t<double>>(in, writer, count, [](istream &in, line_t<double> &l) {
+                        in >> l.a >> l.b >> l.c;
+                    });
+                    break;
+                case 'm': {
+                    vector<uint64_t> offsets(1, 0);
+                    vector<point_t<ll>> points;
+                    for (size_t i = 0; i < count; i++) {
+                        size_t n = 0;
+                        in >> n;
+                        points.resize(points.size() + n);
+                        for (size_t j = offsets.back(); j < points.size(); j++) {
+                            in >> points[j];
+                        }
+                        offsets.push_back(points.size());
+                    }
+                    if (!in) {
+                        throw runtime_error("input ended early");
+                    }
+                    writer.write(offsets);
+                    writer.write(points);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    } catch (exception const &e) {
+        cerr << e.what() << '\n';
+        return 1;
+    }
+    out.flush();
+    return out ? 0 : 1;
+
+}